@@ -0,0 +1,47 @@
+#!/bin/bash
+# Measure the compile time and the code size of a test binary with many assertions.
+# Usage: ./assertion_size.sh [assertions] [include dir] [compiler flags]
+
+set -e
+
+N=${1:-10000}
+INCLUDE=${2:-$(dirname "$0")/../include}
+FLAGS=${3:--O2}
+CXX=${CXX:-g++}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+# Each testcase asserts on a mix of types, as real tests do.
+{
+  echo '#include <string>'
+  echo '#include <vector>'
+  echo '#include "tpp.hpp"'
+  echo 'TPP_DEFAULT_MAIN'
+  echo 'TPP_EPSILON(0.000001)'
+  echo 'struct point { int x; int y; bool operator==(point const& o) const { return x == o.x && y == o.y; } };'
+  echo 'static std::vector<int> const vec{1, 2, 3};'
+  echo 'SUITE("size") {'
+  for ((i = 0; i < N; i += 8)); do
+    echo "  TEST(\"t$i\") {"
+    echo "    ASSERT_EQ($i, $i);"
+    echo "    ASSERT_EQ(std::string(\"s$i\"), \"s$i\");"
+    echo "    ASSERT_EQ($i.5, $i.5);"
+    echo "    ASSERT_LT(${i}U, $((i + 1))U);"
+    echo "    ASSERT_GT($((i + 1))L, ${i}L);"
+    echo "    ASSERT_IN(2, vec);"
+    echo "    ASSERT_TRUE($i >= 0);"
+    echo "    ASSERT_EQ((point{$i, 1}), (point{$i, 1}));"
+    echo "  };"
+  done
+  echo '};'
+} > "$WORK/size_tests.cpp"
+
+START=$(date +%s.%N)
+$CXX -std=c++11 $FLAGS -I"$INCLUDE" -o "$WORK/size_tests" "$WORK/size_tests.cpp"
+END=$(date +%s.%N)
+
+"$WORK/size_tests" > /dev/null
+echo "assertions: $N"
+echo "compile time: $(awk "BEGIN { print $END - $START }") s"
+size "$WORK/size_tests" | awk 'NR == 2 { print "text: " $1 " bytes" }'
+echo "binary: $(stat -c %s "$WORK/size_tests") bytes"
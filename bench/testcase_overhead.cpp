@@ -0,0 +1,79 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Measure the overhead of the framework per empty testcase in sequential mode. The testcases do nothing, hence all
+ * time spent is overhead. Each testsuite is run several times, and the best run counts, to suppress noise of the system.
+ * Fails, if the overhead of a testcase exceeds the limit.
+ * Usage: bench_overhead [testcases] [limit in ns]
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+
+#include "tpp.hpp"
+
+using tpp::intern::duration;
+using tpp::intern::test::testsuite;
+
+/// Run a testsuite made by make_ several times, and get the best overhead per testcase in ns.
+template<typename Fn>
+static auto
+best_of(std::size_t rounds_, std::size_t n_, Fn&& make_) -> double {
+    double best{-1.};
+    for (std::size_t r{0}; r < rounds_; ++r) {
+        auto     ts{make_()};
+        duration d;
+        ts->run();
+        auto const ns{d.get() * 1e6 / static_cast<double>(n_)};
+        if (ts->statistics().failures() + ts->statistics().errors() != 0) {
+            return -1.;
+        }
+        best = best < .0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+auto
+main(int argc_, char const** argv_) -> int {
+    std::size_t const n{argc_ > 1 ? static_cast<std::size_t>(std::atoll(argv_[1])) : 200000};
+    double const      limit{argc_ > 2 ? std::atof(argv_[2]) : 100.};
+    std::size_t const rounds{5};
+
+    auto const tests_ns{best_of(rounds, n, [&] {
+        auto ts{testsuite::create("tests")};
+        for (std::size_t i{0}; i < n; ++i) {
+            ts->test("empty", [] {});
+        }
+        return ts;
+    })};
+    auto const gens_ns{best_of(rounds, n, [&] {
+        auto ts{testsuite::create("generated")};
+        ts->generate("empty", n, [](std::size_t) {});
+        return ts;
+    })};
+
+    std::cout << "TEST:           " << tests_ns << " ns per testcase\n"
+              << "TEST_GENERATOR: " << gens_ns << " ns per testcase" << std::endl;
+    if (tests_ns < .0 || gens_ns < .0 || tests_ns > limit || gens_ns > limit) {
+        std::cout << "The overhead exceeds the limit of " << limit << " ns!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
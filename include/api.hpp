@@ -20,73 +20,81 @@
 #ifndef TPP_API_HPP
 #define TPP_API_HPP
 
+#include <cstddef>
 #include <utility>
 
-namespace tpp
-{
-namespace intern
-{
-template<typename T>
-struct singleton final
-{
-    template<typename... Args>
-    static auto
-    instance(Args&&... args_) noexcept -> T const& {
-        static T const inst(std::forward<Args>(args_)...);
-        return inst;
-    }
-};
-}  // namespace intern
-}  // namespace tpp
-
 #define TPP_INTERN_CONCAT3(A, B, C) A##B##C
 #define TPP_INTERN_API_TEST_NAME(ID) TPP_INTERN_CONCAT3(tpp_intern_test_, ID, _)
 #define TPP_INTERN_API_TEST_INST(ID) TPP_INTERN_CONCAT3(tpp_intern_test_, ID, _inst_)
 #define TPP_INTERN_API_TEST_FN(ID) TPP_INTERN_CONCAT3(tpp_intern_test_fn_, ID, _)
 #define TPP_INTERN_API_SUITE_NS(ID) TPP_INTERN_CONCAT3(tpp_intern_ns_, ID, _)
 #define TPP_INTERN_API_SUITE_NAME(ID) TPP_INTERN_CONCAT3(tpp_intern_suite_, ID, _)
+#define TPP_INTERN_API_SECTION_NAME(ID) TPP_INTERN_CONCAT3(tpp_intern_section_, ID, _)
 
-#define TPP_INTERN_API_SUITE_WRAPPER(DESCR, BASE)                                                      \
-    namespace TPP_INTERN_API_SUITE_NS(__LINE__) {                                                      \
-        class test_module                                                                              \
-        {                                                                                              \
-            tpp::intern::test::testsuite_ptr m_ts_;                                                    \
-                                                                                                       \
-        public:                                                                                        \
-            test_module(test_module const&)     = delete;                                              \
-            test_module(test_module&&) noexcept = delete;                                              \
-            virtual ~test_module() noexcept     = default;                                             \
-            auto                                                                                       \
-            operator=(test_module const&) -> test_module& = delete;                                    \
-            auto                                                                                       \
-            operator=(test_module&&) noexcept -> test_module& = delete;                                \
-                                                                                                       \
-        protected:                                                                                     \
-            test_module() : m_ts_(tpp::intern::test::BASE::create(DESCR)) {                            \
-                tpp::runner::instance().add_testsuite(m_ts_);                                          \
-            }                                                                                          \
-            auto                                                                                       \
-            tpp_intern_ts_() const -> tpp::intern::test::testsuite_ptr const& {                        \
-                return m_ts_;                                                                          \
-            }                                                                                          \
-        };                                                                                             \
-        class TPP_INTERN_API_SUITE_NAME(__LINE__);                                                     \
-        using tpp_intern_mod_type_         = TPP_INTERN_API_SUITE_NAME(__LINE__);                      \
-        static auto const& tpp_intern_mod_ = tpp::intern::singleton<tpp_intern_mod_type_>::instance(); \
-    }                                                                                                  \
-    class TPP_INTERN_API_SUITE_NS(__LINE__)::TPP_INTERN_API_SUITE_NAME(__LINE__)                       \
+#define TPP_INTERN_API_SUITE_WRAPPER(DESCR, BASE)                                                                      \
+    namespace TPP_INTERN_API_SUITE_NS(__LINE__) {                                                                      \
+        class test_module                                                                                              \
+        {                                                                                                              \
+            tpp::intern::test::testsuite_ptr m_ts_;                                                                    \
+                                                                                                                       \
+        public:                                                                                                        \
+            test_module(test_module const&)     = delete;                                                              \
+            test_module(test_module&&) noexcept = delete;                                                              \
+            virtual ~test_module() noexcept     = default;                                                             \
+            auto                                                                                                       \
+            operator=(test_module const&) -> test_module& = delete;                                                    \
+            auto                                                                                                       \
+            operator=(test_module&&) noexcept -> test_module& = delete;                                                \
+            auto                                                                                                       \
+            tpp_intern_ts_() const -> tpp::intern::test::testsuite_ptr const& {                                        \
+                return m_ts_;                                                                                          \
+            }                                                                                                          \
+            auto                                                                                                       \
+            tpp_intern_release_() -> tpp::intern::test::testsuite_ptr {                                                \
+                return std::move(m_ts_);                                                                               \
+            }                                                                                                          \
+                                                                                                                       \
+        protected:                                                                                                     \
+            test_module() : m_ts_(tpp::intern::test::BASE::create(DESCR)) {}                                           \
+        };                                                                                                             \
+        class TPP_INTERN_API_SUITE_NAME(__LINE__);                                                                     \
+        using tpp_intern_mod_type_ = TPP_INTERN_API_SUITE_NAME(__LINE__);                                              \
+        static tpp::intern::suite_descriptor tpp_intern_desc_{DESCR, tpp::intern::create_suite<tpp_intern_mod_type_>}; \
+    }                                                                                                                  \
+    class TPP_INTERN_API_SUITE_NS(__LINE__)::TPP_INTERN_API_SUITE_NAME(__LINE__)                                       \
         : public TPP_INTERN_API_SUITE_NS(__LINE__)::test_module
 
-#define TPP_INTERN_API_TEST_WRAPPER(DESCR)                                                          \
-    class TPP_INTERN_API_TEST_NAME(__LINE__)                                                        \
-    {                                                                                               \
-    public:                                                                                         \
-        explicit TPP_INTERN_API_TEST_NAME(__LINE__)(tpp_intern_mod_type_ * mod_) {                  \
-            mod_->tpp_intern_ts_()->test(DESCR, [=] { mod_->TPP_INTERN_API_TEST_FN(__LINE__)(); }); \
-        }                                                                                           \
-    } TPP_INTERN_API_TEST_INST(__LINE__){this};                                                     \
+#define TPP_INTERN_API_TEST_WRAPPER(DESCR)                                                                \
+    class TPP_INTERN_API_TEST_NAME(__LINE__)                                                              \
+    {                                                                                                     \
+    public:                                                                                               \
+        explicit TPP_INTERN_API_TEST_NAME(__LINE__)(tpp_intern_mod_type_ * mod_) {                        \
+            static_cast<void>(&tpp::intern::test_registration<TPP_INTERN_API_TEST_NAME(__LINE__)>::desc); \
+            mod_->tpp_intern_ts_()->test(DESCR, [=] { mod_->TPP_INTERN_API_TEST_FN(__LINE__)(); });       \
+        }                                                                                                 \
+        static auto                                                                                       \
+        tpp_intern_declaration_() -> tpp::intern::test_declaration {                                      \
+            return tpp::intern::test_declaration{&tpp_intern_desc_, DESCR, __FILE__, __LINE__};           \
+        }                                                                                                 \
+    } TPP_INTERN_API_TEST_INST(__LINE__){this};                                                           \
     void TPP_INTERN_API_TEST_FN(__LINE__)()
 
+#define TPP_INTERN_API_GEN_WRAPPER(DESCR, N, IDX)                                                                  \
+    class TPP_INTERN_API_TEST_NAME(__LINE__)                                                                       \
+    {                                                                                                              \
+    public:                                                                                                        \
+        explicit TPP_INTERN_API_TEST_NAME(__LINE__)(tpp_intern_mod_type_ * mod_) {                                 \
+            static_cast<void>(&tpp::intern::test_registration<TPP_INTERN_API_TEST_NAME(__LINE__)>::desc);          \
+            mod_->tpp_intern_ts_()->generate(DESCR, N,                                                             \
+                                             [=](std::size_t i_) { mod_->TPP_INTERN_API_TEST_FN(__LINE__)(i_); }); \
+        }                                                                                                          \
+        static auto                                                                                                \
+        tpp_intern_declaration_() -> tpp::intern::test_declaration {                                               \
+            return tpp::intern::test_declaration{&tpp_intern_desc_, DESCR, __FILE__, __LINE__};                    \
+        }                                                                                                          \
+    } TPP_INTERN_API_TEST_INST(__LINE__){this};                                                                    \
+    void TPP_INTERN_API_TEST_FN(__LINE__)(std::size_t IDX)
+
 #define TPP_INTERN_API_FN_WRAPPER(FN)                                           \
     class tpp_intern_##FN##_                                                    \
     {                                                                           \
@@ -181,6 +189,45 @@ struct singleton final
  */
 #define IT(DESCR) TPP_INTERN_API_TEST_WRAPPER("It " DESCR)
 
+/**
+ * Create a section inside a testcase. The testcase is run once for each leaf section, where only the sections on the
+ * way to this leaf are entered. Hence everything outside of the sections is done freshly for each of them.
+ * Each leaf section is reported as its own testcase. In a parallel testsuite sections are run in parallel.
+ *
+ * @param DESCR is a cstring with the description, or name of the section. It must be unique in its enclosing scope.
+ *
+ * EXAMPLE:
+ * @code
+ * TEST("some test") {
+ *   // setup
+ *   SECTION("some case") {
+ *     // assertions
+ *   }
+ *   SECTION("other case") {
+ *     // assertions
+ *   }
+ * }
+ * @endcode
+ */
+#define SECTION(DESCR) if (tpp::intern::test::section const TPP_INTERN_API_SECTION_NAME(__LINE__){DESCR})
+
+/**
+ * Create a generator for testcases. The testcases are generated on demand, when the testsuite is run.
+ * Hence the memory used does not depend on the number of testcases.
+ *
+ * @param DESCR is a cstring with the description, or name of the generated testcases.
+ * @param N is the number of testcases to generate.
+ * @param IDX is the name of the index parameter, by which testcases can be distinguished.
+ *
+ * EXAMPLE:
+ * @code
+ * TEST_GENERATOR("some generated test", 1000000, i) {
+ *   // assertions depending on i
+ * }
+ * @endcode
+ */
+#define TEST_GENERATOR(DESCR, N, IDX) TPP_INTERN_API_GEN_WRAPPER(DESCR, N, IDX)
+
 /**
  * Create a definition for a function as part of a testsuite, that is executed once before each
  * testcase is run.
@@ -233,4 +280,52 @@ struct singleton final
  */
 #define TEARDOWN() TPP_INTERN_API_FN_WRAPPER(teardown)
 
+/**
+ * Declare a global fixture as member of a testsuite. Global fixtures of the same name and type are shared by all
+ * testsuites, that declare them. A fixture is default constructed on first use, and destroyed after the last of these
+ * testsuites has finished. Access to it is thread-safe, but the fixture itself is not synchronized.
+ *
+ * @param NAME is the name of the member, by which the fixture is accessed like by a pointer.
+ * @param ... is the type of the fixture.
+ *
+ * EXAMPLE:
+ * @code
+ * GLOBAL_FIXTURE(db, database);
+ *
+ * TEST("query") {
+ *   ASSERT_EQ(db->query("SELECT 1"), 1);
+ * }
+ * @endcode
+ */
+#define GLOBAL_FIXTURE(NAME, ...) tpp::intern::fixture_handle<__VA_ARGS__> const NAME{tpp_intern_ts_(), #NAME}
+
+/**
+ * Declare a pool of fixtures as member of a testsuite. Testcases check out an instance for exclusive use, which is
+ * returned, when the lease goes out of scope. At most SIZE instances are default constructed on demand, and reused
+ * afterwards. A hook to reset an instance in between two uses can be set by on_reset, for example in SETUP.
+ *
+ * @param NAME is the name of the member.
+ * @param TYPE is the type of the fixtures.
+ * @param SIZE is the maximum number of instances.
+ *
+ * EXAMPLE:
+ * @code
+ * FIXTURE_POOL(conns, connection, 4);
+ *
+ * TEST("query") {
+ *   auto conn{conns.checkout()};
+ *   ASSERT_EQ(conn->query("SELECT 1"), 1);
+ * }
+ * @endcode
+ */
+#define FIXTURE_POOL(NAME, TYPE, SIZE) tpp::intern::test::fixture_pool<TYPE> NAME{SIZE}
+
+/**
+ * Define a default main function, which performs all tests and allows modification via command line arguments.
+ */
+#define TPP_DEFAULT_MAIN                            \
+    auto main(int argc_, char const** argv_)->int { \
+        return tpp::intern::run_main(argc_, argv_); \
+    }
+
 #endif  // TPP_API_HPP
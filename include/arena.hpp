@@ -0,0 +1,256 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_ARENA_HPP
+#define TPP_ARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <stdexcept>
+
+#include "cpp_meta.hpp"
+#include "fatal.hpp"
+
+#ifdef TPP_INTERN_HAS_PMR
+#    include <memory_resource>
+#endif
+
+namespace tpp
+{
+namespace intern
+{
+/**
+ * A monotonic memory arena, which is private to one run of a testcase. Memory is taken from blocks of growing size,
+ * and never freed individually, but all at once after the run. Hence objects allocated in it must not outlive the
+ * run, and their destructors need not be called, if they only own memory of the arena.
+ * The arena is not synchronized, further threads of a testcase must not allocate concurrently.
+ * With C++17 it is a std::pmr::memory_resource.
+ */
+class arena final
+#ifdef TPP_INTERN_HAS_PMR
+    : public std::pmr::memory_resource
+#endif
+{
+public:
+    class scope final
+    {
+    public:
+        explicit scope(arena* a_) : m_prev(current()) {
+            current() = a_;
+        }
+
+        ~scope() noexcept {
+            current() = m_prev;
+        }
+
+        scope(scope const&) = delete;
+        auto
+        operator=(scope const&) -> scope& = delete;
+
+    private:
+        arena* m_prev;
+    };
+
+    arena()             = default;
+    arena(arena const&) = delete;
+    auto
+    operator=(arena const&) -> arena& = delete;
+
+    ~arena() noexcept {
+        release();
+    }
+
+    /// Get the arena of the testcase, that runs in the current thread, or nullptr outside of testcases.
+    static auto
+    current() -> arena*& {
+        static thread_local arena* a{nullptr};
+        return a;
+    }
+
+    /// Allocate size_ bytes aligned to align_, which must be a power of two.
+    auto
+    allocate(std::size_t size_, std::size_t align_ = alignof(std::max_align_t)) -> void* {
+        auto p{align_up(m_pos, align_)};
+        if (!m_head || p > m_end || size_ > static_cast<std::size_t>(m_end - p)) {
+            grow(size_, align_);
+            p = align_up(m_pos, align_);
+        }
+        m_used += static_cast<std::size_t>(p - m_pos) + size_;
+        m_pos = p + size_;
+        return p;
+    }
+
+    /// Free all memory at once.
+    void
+    release() noexcept {
+        while (m_head) {
+            auto* const next{m_head->next};
+            ::operator delete(m_head);
+            m_head = next;
+        }
+        m_pos  = nullptr;
+        m_end  = nullptr;
+        m_used = 0;
+    }
+
+    /// Get the number of bytes, that were allocated including padding for alignment, since the last release.
+    inline auto
+    high_water() const -> std::size_t {
+        return m_used;
+    }
+
+    /// Get the number of bytes, that are reserved in blocks.
+    inline auto
+    reserved() const -> std::size_t {
+        return m_reserved;
+    }
+
+private:
+    static constexpr std::size_t FIRST_BLOCK = 64 * 1024;
+
+    struct block
+    {
+        block*      next;
+        std::size_t size;
+    };
+
+    static auto
+    align_up(char* p_, std::size_t align_) -> char* {
+        auto const addr{reinterpret_cast<std::uintptr_t>(p_)};
+        return reinterpret_cast<char*>((addr + align_ - 1) & ~static_cast<std::uintptr_t>(align_ - 1));
+    }
+
+    /// Add a block, which is at least twice as large as the previous one, and fits the requested allocation.
+    void
+    grow(std::size_t size_, std::size_t align_) {
+        auto const header{sizeof(block) + alignof(std::max_align_t)};
+        if (size_ > std::numeric_limits<std::size_t>::max() / 2 - header - align_) {
+            TPP_INTERN_THROW(std::bad_alloc());
+        }
+        auto const need{header + align_ + size_};
+        auto const size{std::max(need, m_head ? m_head->size * 2 : FIRST_BLOCK)};
+        auto*      b{static_cast<block*>(::operator new(size))};
+        b->next = m_head;
+        b->size = size;
+        m_head  = b;
+        m_pos   = reinterpret_cast<char*>(b) + sizeof(block);
+        m_end   = reinterpret_cast<char*>(b) + size;
+        m_reserved += size;
+    }
+
+#ifdef TPP_INTERN_HAS_PMR
+    auto
+    do_allocate(std::size_t size_, std::size_t align_) -> void* override {
+        return allocate(size_, align_);
+    }
+
+    void
+    do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    auto
+    do_is_equal(std::pmr::memory_resource const& other_) const noexcept -> bool override {
+        return this == &other_;
+    }
+#endif
+
+    block*      m_head{nullptr};
+    char*       m_pos{nullptr};
+    char*       m_end{nullptr};
+    std::size_t m_used{0};
+    std::size_t m_reserved{0};
+};
+
+/// An allocator, that takes memory from an arena, and never frees it individually.
+template<typename T>
+class arena_allocator
+{
+public:
+    using value_type = T;
+
+    /// Use the arena of the current testcase.
+    arena_allocator();
+
+    explicit arena_allocator(arena& a_) noexcept : m_arena(&a_) {}
+
+    template<typename U>
+    arena_allocator(arena_allocator<U> const& other_) noexcept : m_arena(&other_.resource()) {}
+
+    auto
+    allocate(std::size_t n_) -> T* {
+        if (n_ > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            TPP_INTERN_THROW(std::bad_alloc());
+        }
+        return static_cast<T*>(m_arena->allocate(n_ * sizeof(T), alignof(T)));
+    }
+
+    void
+    deallocate(T*, std::size_t) noexcept {}
+
+    inline auto
+    resource() const -> arena& {
+        return *m_arena;
+    }
+
+    template<typename U>
+    auto
+    operator==(arena_allocator<U> const& other_) const -> bool {
+        return m_arena == &other_.resource();
+    }
+
+    template<typename U>
+    auto
+    operator!=(arena_allocator<U> const& other_) const -> bool {
+        return m_arena != &other_.resource();
+    }
+
+private:
+    arena* m_arena;
+};
+}  // namespace intern
+
+/**
+ * Get the memory arena of the current run of a testcase. All memory allocated in it is freed at once, when the run
+ * has finished. The number of bytes allocated is reported for each testcase. Other threads of a testcase can use the
+ * arena, but not call this function, and must not allocate concurrently.
+ *
+ * EXAMPLE:
+ * @code
+ * std::vector<node, tpp::arena_allocator<node>> nodes;  // C++11
+ * std::pmr::vector<node> more(&tpp::arena());           // C++17
+ * @endcode
+ */
+inline auto
+arena() -> intern::arena& {
+    auto* a{intern::arena::current()};
+    if (!a) {
+        TPP_INTERN_THROW(std::logic_error("arena can only be used in testcases"));
+    }
+    return *a;
+}
+
+/// An allocator for standard containers, that takes memory from the arena of the current testcase.
+template<typename T>
+using arena_allocator = intern::arena_allocator<T>;
+
+template<typename T>
+intern::arena_allocator<T>::arena_allocator() : m_arena(&tpp::arena()) {}
+}  // namespace tpp
+
+#endif  // TPP_ARENA_HPP
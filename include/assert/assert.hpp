@@ -20,7 +20,13 @@
 #ifndef TPP_ASSERT_ASSERT_HPP
 #define TPP_ASSERT_ASSERT_HPP
 
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
 #include <tuple>
+#include <utility>
 
 #include "assert/assertion_failure.hpp"
 #include "assert/loc.hpp"
@@ -57,17 +63,81 @@ make_assertion(Args&&... args) -> A {
     return A{std::forward<Args>(args)...};
 }
 
-static inline void
+/// Collects the failure of assertions in the current thread instead of failing, while an assertion is polled.
+class failure_probe final
+{
+public:
+    failure_probe() : m_prev(current()) {
+        current() = this;
+    }
+
+    ~failure_probe() noexcept {
+        current() = m_prev;
+    }
+
+    failure_probe(failure_probe const&) = delete;
+    auto
+    operator=(failure_probe const&) -> failure_probe& = delete;
+
+    static auto
+    current() -> failure_probe*& {
+        static thread_local failure_probe* p{nullptr};
+        return p;
+    }
+
+    bool        failed{false};
+    std::string msg;
+
+private:
+    failure_probe* m_prev;
+};
+
+TPP_INTERN_COLD inline void
 fail_assertion(std::tuple<std::string&&, char const*, std::string&&>&& asrt_, loc const& loc_) {
-    throw assertion_failure{std::string("Expected ")
-                              .append(std::get<0>(asrt_))  // value
-                              .append(" ")
-                              .append(std::get<1>(asrt_))  // constraint
-                              .append(" ")
-                              .append(std::get<2>(asrt_)),  // expected
-                            loc_};
+    auto msg{std::string("Expected ")
+               .append(std::get<0>(asrt_))  // value
+               .append(" ")
+               .append(std::get<1>(asrt_))  // constraint
+               .append(" ")
+               .append(std::get<2>(asrt_))};  // expected
+    auto* const probe{failure_probe::current()};
+    if (probe) {
+        probe->failed = true;
+        probe->msg    = std::move(msg);
+        return;
+    }
+    fail_with(assertion_failure{msg, loc_});
+}
+
+/**
+ * Operand of a failed assertion, whose type is erased. It is stringified only on failure, hence an assertion site
+ * compiles to the comparison, and a call of fail_comparison. The stringifier is instantiated once per type.
+ */
+struct operand
+{
+    void const* value;
+    std::string (*str)(void const*);
+};
+
+template<typename T>
+TPP_INTERN_COLD auto
+stringify_operand(void const* v_) -> std::string {
+    return to_string(*static_cast<T const*>(v_));
+}
+
+template<typename T>
+inline auto
+operand_of(T const& v_) -> operand {
+    return operand{static_cast<void const*>(std::addressof(v_)), &stringify_operand<T>};
+}
+
+/// Fail an assertion, that compared v_ against e_ by the constraint cmp_.
+TPP_INTERN_COLD inline void
+fail_comparison(operand v_, char const* cmp_, operand e_, loc const& loc_) {
+    fail_assertion(std::forward_as_tuple(v_.str(v_.value), cmp_, e_.str(e_.value)), loc_);
 }
 
+#ifndef TPP_INTERN_NO_EXCEPTIONS
 template<typename T, typename Fn>
 static auto
 assert_throws(Fn&& fn_, char const* tname_, loc&& loc_) -> throwable<T> {
@@ -109,18 +179,19 @@ assert_nothrow(Fn&& fn_, loc&& loc_) {
         throw assertion_failure("Expected no exception", loc_);
     }
 }
+#endif
 
 template<typename Fn, TPP_INTERN_ENABLE_IF(!TPP_INTERN_IS_VOID(decltype(std::declval<Fn>()())))>
 static auto
 assert_runtime(Fn&& fn_, double max_ms_, loc&& loc_) -> decltype(fn_()) {
     TPP_INTERN_SYNC {
-        duration        dur;
-        decltype(fn_()) res{fn_()};
-        double          dur_ms{dur.get()};
+        virtual_duration dur;
+        decltype(fn_())  res{fn_()};
+        double           dur_ms{dur.get()};
         if (dur_ms > max_ms_) {
-            throw assertion_failure("Expected the runtime to be less " + to_string(max_ms_) + "ms, but was " +
-                                      to_string(dur_ms) + "ms",
-                                    loc_);
+            fail_with(assertion_failure("Expected the runtime to be less " + to_string(max_ms_) + "ms, but was " +
+                                          to_string(dur_ms) + "ms",
+                                        loc_));
         }
         return res;
     }
@@ -131,19 +202,64 @@ static void
 assert_runtime(Fn&& fn_, double max_ms_, loc&& loc_) {
     double dur_ms{.0};
     TPP_INTERN_SYNC {
-        duration dur;
+        virtual_duration dur;
         fn_();
         dur_ms = dur.get();
     }
     if (dur_ms > max_ms_) {
-        throw assertion_failure(
-          "Expected the runtime to be less " + to_string(max_ms_) + "ms, but was " + to_string(dur_ms) + "ms", loc_);
+        fail_with(assertion_failure(
+          "Expected the runtime to be less " + to_string(max_ms_) + "ms, but was " + to_string(dur_ms) + "ms", loc_));
+    }
+}
+
+/**
+ * Poll an assertion A of the value returned by fn_, until it holds. The polling interval starts at a microsecond,
+ * and doubles up to 100ms. Polling is done in real time, as the awaited work usually happens in other threads,
+ * that do not use the virtual time of the testcase.
+ */
+template<typename A, typename Fn, typename E>
+static void
+assert_eventually(Fn&& fn_, E&& e_, double timeout_ms_, loc&& loc_) {
+    duration                  dur;
+    std::chrono::microseconds delay{1};
+    for (;;) {
+        failure_probe probe;
+        make_assertion<A>(fn_(), e_, false, loc(loc_));
+        if (!probe.failed) {
+            return;
+        }
+        auto const remaining{timeout_ms_ - dur.get()};
+        if (remaining <= .0) {
+            fail_with(assertion_failure(probe.msg + " within " + to_string(timeout_ms_) + "ms", loc_));
+            return;
+        }
+        auto const left{std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::duration<double, std::milli>(remaining))};
+        std::this_thread::sleep_for(std::min(delay, left));
+        delay = std::min(delay * 2, std::chrono::microseconds(100000));
     }
 }
 }  // namespace assert
 }  // namespace intern
 }  // namespace tpp
 
+/**
+ * Wrap the statement of an assertion. Without exceptions, the enclosing function is left by return, if the
+ * testcase has failed. Hence assertions can then only be used in functions returning void.
+ * The switch prevents the else from binding to an enclosing if statement.
+ */
+#ifdef TPP_INTERN_NO_EXCEPTIONS
+#    define TPP_INTERN_ASSERTION(...)                                                               \
+        switch (0)                                                                                  \
+        case 0:                                                                                     \
+        default:                                                                                    \
+            if ((static_cast<void>(__VA_ARGS__), !tpp::intern::assert::current_failure().failed)) { \
+            } else                                                                                  \
+                return
+#else
+#    define TPP_INTERN_ASSERTION(...) __VA_ARGS__
+#endif
+
 /**
  * Invoke this macro to define an assertion.
  *
@@ -171,10 +287,9 @@ assert_runtime(Fn&& fn_, double max_ms_, loc&& loc_) {
     {                                                                                                                 \
         template<typename V, typename E = V>                                                                          \
         NAME(V&& v_, E&& e_, bool neg_, loc&& loc_) {                                                                 \
-            if ((PRED) == neg_) {                                                                                     \
-                fail_assertion(std::forward_as_tuple(                                                                 \
-                                 to_string(v_), (neg_ ? ns_##NAME::NEG_CMP_STR : ns_##NAME::CMP_STR), to_string(e_)), \
-                               loc_);                                                                                 \
+            if (TPP_INTERN_UNLIKELY((PRED) == neg_)) {                                                                \
+                fail_comparison(operand_of(v_), neg_ ? ns_##NAME::NEG_CMP_STR : ns_##NAME::CMP_STR, operand_of(e_),   \
+                                loc_);                                                                                \
             }                                                                                                         \
         }                                                                                                             \
     };                                                                                                                \
@@ -215,9 +330,9 @@ assert_runtime(Fn&& fn_, double max_ms_, loc&& loc_) {
  * ASSERT(1., EQ, 1.2, 0.01);
  * @endcode
  */
-#define ASSERT(V, A, ...)                                                      \
-    tpp::intern::assert::make_assertion<tpp::assert::A>(V, __VA_ARGS__, false, \
-                                                        tpp::intern::assert::loc{__FILE__, __LINE__})
+#define ASSERT(V, A, ...)                                              \
+    TPP_INTERN_ASSERTION(tpp::intern::assert::make_assertion<tpp::assert::A>( \
+      V, __VA_ARGS__, false, tpp::intern::assert::loc{__FILE__, __LINE__}))
 
 /**
  * Generic macro to compare two values based on the given assertion with negated result.
@@ -232,9 +347,9 @@ assert_runtime(Fn&& fn_, double max_ms_, loc&& loc_) {
  * ASSERT_NOT(1., EQ, 2.2, 0.01);
  * @endcode
  */
-#define ASSERT_NOT(V, A, ...)                                                   \
-    tpp::intern::assert::make_assertion<tpp::assert::A>((V), __VA_ARGS__, true, \
-                                                        tpp::intern::assert::loc{__FILE__, __LINE__})
+#define ASSERT_NOT(V, A, ...)                                          \
+    TPP_INTERN_ASSERTION(tpp::intern::assert::make_assertion<tpp::assert::A>( \
+      (V), __VA_ARGS__, true, tpp::intern::assert::loc{__FILE__, __LINE__}))
 
 /**
  * Assert a value to be true.
@@ -302,8 +417,12 @@ assert_runtime(Fn&& fn_, double max_ms_, loc&& loc_) {
  * ASSERT_THROWS(func(), std::exception);
  * @endcode
  */
-#define ASSERT_THROWS(F, T) \
-    tpp::intern::assert::assert_throws<T>([&] { F; }, #T, tpp::intern::assert::loc{__FILE__, __LINE__}).cause()
+#ifdef TPP_INTERN_NO_EXCEPTIONS
+#    define ASSERT_THROWS(F, T) static_assert(false, "ASSERT_THROWS requires exceptions!")
+#else
+#    define ASSERT_THROWS(F, T) \
+        tpp::intern::assert::assert_throws<T>([&] { F; }, #T, tpp::intern::assert::loc{__FILE__, __LINE__}).cause()
+#endif
 
 /**
  * Assert an expression to not throw anything.
@@ -316,7 +435,12 @@ assert_runtime(Fn&& fn_, double max_ms_, loc&& loc_) {
  * ASSERT_NOTHROW(func());
  * @endcode
  */
-#define ASSERT_NOTHROW(F) tpp::intern::assert::assert_nothrow([&] { F; }, tpp::intern::assert::loc{__FILE__, __LINE__})
+#ifdef TPP_INTERN_NO_EXCEPTIONS
+#    define ASSERT_NOTHROW(F) [&] { F; }()
+#else
+#    define ASSERT_NOTHROW(F) \
+        tpp::intern::assert::assert_nothrow([&] { F; }, tpp::intern::assert::loc{__FILE__, __LINE__})
+#endif
 
 /**
  * Assert an expression to run in certain amount of time.
@@ -23,6 +23,8 @@
 
 #include "assert/loc.hpp"
 
+#include "cpp_meta.hpp"
+
 namespace tpp
 {
 namespace intern
@@ -43,6 +45,36 @@ public:
 private:
     std::string const m_msg;
 };
+
+/// The state of the current testcase, where assertion failures are recorded, if exceptions are disabled.
+struct failure_state
+{
+    bool        failed{false};
+    std::string msg;
+};
+
+inline auto
+current_failure() -> failure_state& {
+    static thread_local failure_state f;
+    return f;
+}
+
+/**
+ * Fail the current testcase. Without exceptions, only the first failure is recorded, and the assertion macros
+ * return from the testcase body afterwards.
+ */
+inline void
+fail_with(assertion_failure const& e_) {
+#ifdef TPP_INTERN_NO_EXCEPTIONS
+    auto& f{current_failure()};
+    if (!f.failed) {
+        f.failed = true;
+        f.msg    = e_.what();
+    }
+#else
+    throw e_;
+#endif
+}
 }  // namespace assert
 }  // namespace intern
 }  // namespace tpp
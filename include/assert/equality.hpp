@@ -60,10 +60,8 @@ struct assert_equals
 {
     template<typename V, typename E = V, TPP_INTERN_ENABLE_IF(!TPP_INTERN_IS_FLOAT(V) || !TPP_INTERN_IS_FLOAT(E))>
     assert_equals(V&& v_, E&& e_, bool neg_, loc&& loc_) {
-        if ((v_ == e_) == neg_) {
-            fail_assertion(
-              std::forward_as_tuple(to_string(v_), (neg_ ? ns_equals::NEG_CMP_STR : ns_equals::CMP_STR), to_string(e_)),
-              loc_);
+        if (TPP_INTERN_UNLIKELY((v_ == e_) == neg_)) {
+            fail_comparison(operand_of(v_), neg_ ? ns_equals::NEG_CMP_STR : ns_equals::CMP_STR, operand_of(e_), loc_);
         }
     }
 
@@ -73,20 +71,16 @@ struct assert_equals
         static_assert(TPP_INTERN_IS_FLOAT(F),
                       "An epsilon used in floating point comparison must be itself a floating point!");
 
-        if ((std::abs(v_ - e_) <= std::max(std::abs(v_), std::abs(e_)) * eps_) == neg_) {
-            fail_assertion(
-              std::forward_as_tuple(to_string(v_), (neg_ ? ns_equals::NEG_CMP_STR : ns_equals::CMP_STR), to_string(e_)),
-              loc_);
+        if (TPP_INTERN_UNLIKELY((std::abs(v_ - e_) <= std::max(std::abs(v_), std::abs(e_)) * eps_) == neg_)) {
+            fail_comparison(operand_of(v_), neg_ ? ns_equals::NEG_CMP_STR : ns_equals::CMP_STR, operand_of(e_), loc_);
         }
     }
 
     template<typename V, typename E = V, TPP_INTERN_ENABLE_IF(TPP_INTERN_IS_FLOAT(V) && TPP_INTERN_IS_FLOAT(E))>
     assert_equals(V&& v_, E&& e_, bool neg_, loc&& loc_) {
         typename std::decay<E>::type eps_ = static_cast<E>(epsilon);
-        if ((std::abs(v_ - e_) <= std::max(std::abs(v_), std::abs(e_)) * eps_) == neg_) {
-            fail_assertion(
-              std::forward_as_tuple(to_string(v_), (neg_ ? ns_equals::NEG_CMP_STR : ns_equals::CMP_STR), to_string(e_)),
-              loc_);
+        if (TPP_INTERN_UNLIKELY((std::abs(v_ - e_) <= std::max(std::abs(v_), std::abs(e_)) * eps_) == neg_)) {
+            fail_comparison(operand_of(v_), neg_ ? ns_equals::NEG_CMP_STR : ns_equals::CMP_STR, operand_of(e_), loc_);
         }
     }
 };
@@ -108,9 +102,9 @@ TPP_PROVIDE_ASSERTION(assert_equals, EQ)
  * ASSERT_EQ(1.12, 1.11, 0.01);
  * @endcode
  */
-#define ASSERT_EQ(...)                                                       \
-    tpp::intern::assert::make_assertion<tpp::intern::assert::assert_equals>( \
-      __VA_ARGS__, false, tpp::intern::assert::loc{__FILE__, __LINE__})
+#define ASSERT_EQ(...)                                                                            \
+    TPP_INTERN_ASSERTION(tpp::intern::assert::make_assertion<tpp::intern::assert::assert_equals>( \
+      __VA_ARGS__, false, tpp::intern::assert::loc{__FILE__, __LINE__}))
 
 /**
  * Assert two values to be not equal.
@@ -124,8 +118,41 @@ TPP_PROVIDE_ASSERTION(assert_equals, EQ)
  * ASSERT_NOT_EQ(1.12, 1.11, 0.01);
  * @endcode
  */
-#define ASSERT_NOT_EQ(...)                                                   \
-    tpp::intern::assert::make_assertion<tpp::intern::assert::assert_equals>( \
-      __VA_ARGS__, true, tpp::intern::assert::loc{__FILE__, __LINE__})
+#define ASSERT_NOT_EQ(...)                                                                        \
+    TPP_INTERN_ASSERTION(tpp::intern::assert::make_assertion<tpp::intern::assert::assert_equals>( \
+      __VA_ARGS__, true, tpp::intern::assert::loc{__FILE__, __LINE__}))
+
+/**
+ * Assert a condition to become true within some time. The condition is polled with an increasing interval,
+ * and the assertion returns as soon as it holds.
+ *
+ * @param C is the condition, which is evaluated repeatedly.
+ * @param T is the timeout in milliseconds.
+ *
+ * EXAMPLE:
+ * @code
+ * ASSERT_EVENTUALLY(queue.empty(), 1000);
+ * @endcode
+ */
+#define ASSERT_EVENTUALLY(C, T)                                                                      \
+    TPP_INTERN_ASSERTION(tpp::intern::assert::assert_eventually<tpp::intern::assert::assert_equals>( \
+      [&] { return static_cast<bool>(C); }, true, T, tpp::intern::assert::loc{__FILE__, __LINE__}))
+
+/**
+ * Assert a value to become equal to another value within some time. The value is polled with an increasing
+ * interval, and the assertion returns as soon as it is equal. On timeout the last value is reported.
+ *
+ * @param V is the value in question, which is evaluated repeatedly.
+ * @param E is the expected value.
+ * @param T is the timeout in milliseconds.
+ *
+ * EXAMPLE:
+ * @code
+ * ASSERT_EVENTUALLY_EQ(counter.load(), 10, 1000);
+ * @endcode
+ */
+#define ASSERT_EVENTUALLY_EQ(V, E, T)                                                                \
+    TPP_INTERN_ASSERTION(tpp::intern::assert::assert_eventually<tpp::intern::assert::assert_equals>( \
+      [&] { return V; }, E, T, tpp::intern::assert::loc{__FILE__, __LINE__}))
 
 #endif  // TPP_ASSERT_EQUALITY_HPP
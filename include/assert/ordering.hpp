@@ -38,9 +38,9 @@ TPP_PROVIDE_ASSERTION(assert_less, LT)
  * ASSERT_GT(2, 1);
  * @endcode
  */
-#define ASSERT_GT(...)                                                        \
-    tpp::intern::assert::make_assertion<tpp::intern::assert::assert_greater>( \
-      __VA_ARGS__, false, tpp::intern::assert::loc{__FILE__, __LINE__})
+#define ASSERT_GT(...)                                                                             \
+    TPP_INTERN_ASSERTION(tpp::intern::assert::make_assertion<tpp::intern::assert::assert_greater>( \
+      __VA_ARGS__, false, tpp::intern::assert::loc{__FILE__, __LINE__}))
 
 /**
  * Assert a value to be not greater than another value.
@@ -53,9 +53,9 @@ TPP_PROVIDE_ASSERTION(assert_less, LT)
  * ASSERT_NOT_GT(2, 2);
  * @endcode
  */
-#define ASSERT_NOT_GT(...)                                                    \
-    tpp::intern::assert::make_assertion<tpp::intern::assert::assert_greater>( \
-      __VA_ARGS__, true, tpp::intern::assert::loc{__FILE__, __LINE__})
+#define ASSERT_NOT_GT(...)                                                                         \
+    TPP_INTERN_ASSERTION(tpp::intern::assert::make_assertion<tpp::intern::assert::assert_greater>( \
+      __VA_ARGS__, true, tpp::intern::assert::loc{__FILE__, __LINE__}))
 
 /**
  * Assert a value to be less than another value.
@@ -68,9 +68,9 @@ TPP_PROVIDE_ASSERTION(assert_less, LT)
  * ASSERT_LT(1, 2);
  * @endcode
  */
-#define ASSERT_LT(...)                                                     \
-    tpp::intern::assert::make_assertion<tpp::intern::assert::assert_less>( \
-      __VA_ARGS__, false, tpp::intern::assert::loc{__FILE__, __LINE__})
+#define ASSERT_LT(...)                                                                          \
+    TPP_INTERN_ASSERTION(tpp::intern::assert::make_assertion<tpp::intern::assert::assert_less>( \
+      __VA_ARGS__, false, tpp::intern::assert::loc{__FILE__, __LINE__}))
 
 /**
  * Assert a value to be not less than another value.
@@ -83,8 +83,8 @@ TPP_PROVIDE_ASSERTION(assert_less, LT)
  * ASSERT_NOT_LT(1, 1);
  * @endcode
  */
-#define ASSERT_NOT_LT(...)                                                 \
-    tpp::intern::assert::make_assertion<tpp::intern::assert::assert_less>( \
-      __VA_ARGS__, true, tpp::intern::assert::loc{__FILE__, __LINE__})
+#define ASSERT_NOT_LT(...)                                                                      \
+    TPP_INTERN_ASSERTION(tpp::intern::assert::make_assertion<tpp::intern::assert::assert_less>( \
+      __VA_ARGS__, true, tpp::intern::assert::loc{__FILE__, __LINE__}))
 
 #endif  // TPP_ASSERT_ORDERING_HPP
@@ -41,17 +41,15 @@ struct assert_in
     template<typename V, typename E = V,
              TPP_INTERN_ENABLE_IF(TPP_INTERN_HAS_ITERATOR_CAPABILITY(E) && !TPP_INTERN_IS_TYPE(E, std::string))>
     assert_in(V&& v_, E&& e_, bool neg_, loc&& loc_) {
-        if ((std::find(e_.cbegin(), e_.cend(), v_) != e_.cend()) == neg_) {
-            fail_assertion(
-              std::forward_as_tuple(to_string(v_), (neg_ ? ns_in::NEG_CMP_STR : ns_in::CMP_STR), to_string(e_)), loc_);
+        if (TPP_INTERN_UNLIKELY((std::find(e_.cbegin(), e_.cend(), v_) != e_.cend()) == neg_)) {
+            fail_comparison(operand_of(v_), neg_ ? ns_in::NEG_CMP_STR : ns_in::CMP_STR, operand_of(e_), loc_);
         }
     }
 
     template<typename V, typename E = V, TPP_INTERN_ENABLE_IF(TPP_INTERN_IS_TYPE(E, std::string))>
     assert_in(V&& v_, E&& e_, bool neg_, loc&& loc_) {
-        if ((e_.find(v_) != std::string::npos) == neg_) {
-            fail_assertion(
-              std::forward_as_tuple(to_string(v_), (neg_ ? ns_in::NEG_CMP_STR : ns_in::CMP_STR), to_string(e_)), loc_);
+        if (TPP_INTERN_UNLIKELY((e_.find(v_) != std::string::npos) == neg_)) {
+            fail_comparison(operand_of(v_), neg_ ? ns_in::NEG_CMP_STR : ns_in::CMP_STR, operand_of(e_), loc_);
         }
     }
 };
@@ -74,9 +72,9 @@ TPP_PROVIDE_ASSERTION(assert_in, IN)
  * ASSERT_IN("hello", "hello world"s);
  * @endcode
  */
-#define ASSERT_IN(...)                                                                      \
-    tpp::intern::assert::make_assertion<tpp::intern::assert::assert_in>(__VA_ARGS__, false, \
-                                                                        tpp::intern::assert::loc{__FILE__, __LINE__})
+#define ASSERT_IN(...)                                                                        \
+    TPP_INTERN_ASSERTION(tpp::intern::assert::make_assertion<tpp::intern::assert::assert_in>( \
+      __VA_ARGS__, false, tpp::intern::assert::loc{__FILE__, __LINE__}))
 
 /**
  * Assert a range not to contain a value.
@@ -91,8 +89,8 @@ TPP_PROVIDE_ASSERTION(assert_in, IN)
  * ASSERT_NOT_IN("xyz", "hello world"s);
  * @endcode
  */
-#define ASSERT_NOT_IN(...)                                                                 \
-    tpp::intern::assert::make_assertion<tpp::intern::assert::assert_in>(__VA_ARGS__, true, \
-                                                                        tpp::intern::assert::loc{__FILE__, __LINE__})
+#define ASSERT_NOT_IN(...)                                                                    \
+    TPP_INTERN_ASSERTION(tpp::intern::assert::make_assertion<tpp::intern::assert::assert_in>( \
+      __VA_ARGS__, true, tpp::intern::assert::loc{__FILE__, __LINE__}))
 
 #endif  // TPP_ASSERT_RANGE_HPP
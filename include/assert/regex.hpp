@@ -21,13 +21,22 @@
 #define TPP_ASSERT_REGEX_HPP
 
 #include <regex>
+#include <string>
 
 #include "assert/assert.hpp"
 
+#include "../regex.hpp"
+#include "stringify.hpp"
+
 namespace tpp
 {
 namespace intern
 {
+inline auto
+to_string(regex const& arg_) -> std::string {
+    return to_string(arg_.pattern);
+}
+
 namespace assert
 {
 namespace ns_match
@@ -45,19 +54,15 @@ struct assert_match
 {
     template<typename R, typename V, typename E = V>
     assert_match(V&& v_, E&& e_, R& r_, bool neg_, loc&& loc_) {
-        if (std::regex_match(v_, r_, std::regex(e_)) == neg_) {
-            fail_assertion(
-              std::forward_as_tuple(to_string(v_), (neg_ ? ns_match::NEG_CMP_STR : ns_match::CMP_STR), to_string(e_)),
-              loc_);
+        if (TPP_INTERN_UNLIKELY(std::regex_match(v_, r_, std::regex(e_)) == neg_)) {
+            fail_comparison(operand_of(v_), neg_ ? ns_match::NEG_CMP_STR : ns_match::CMP_STR, operand_of(e_), loc_);
         }
     }
 
     template<typename V, typename E = V>
     assert_match(V&& v_, E&& e_, bool neg_, loc&& loc_) {
-        if (std::regex_match(v_, std::regex(e_)) == neg_) {
-            fail_assertion(
-              std::forward_as_tuple(to_string(v_), (neg_ ? ns_match::NEG_CMP_STR : ns_match::CMP_STR), to_string(e_)),
-              loc_);
+        if (TPP_INTERN_UNLIKELY(std::regex_match(v_, std::regex(e_)) == neg_)) {
+            fail_comparison(operand_of(v_), neg_ ? ns_match::NEG_CMP_STR : ns_match::CMP_STR, operand_of(e_), loc_);
         }
     }
 };
@@ -66,19 +71,15 @@ struct assert_like
 {
     template<typename R, typename V, typename E = V>
     assert_like(V&& v_, E&& e_, R& r_, bool neg_, loc&& loc_) {
-        if (std::regex_search(v_, r_, std::regex(e_)) == neg_) {
-            fail_assertion(
-              std::forward_as_tuple(to_string(v_), (neg_ ? ns_like::NEG_CMP_STR : ns_like::CMP_STR), to_string(e_)),
-              loc_);
+        if (TPP_INTERN_UNLIKELY(std::regex_search(v_, r_, std::regex(e_)) == neg_)) {
+            fail_comparison(operand_of(v_), neg_ ? ns_like::NEG_CMP_STR : ns_like::CMP_STR, operand_of(e_), loc_);
         }
     }
 
     template<typename V, typename E = V>
     assert_like(V&& v_, E&& e_, bool neg_, loc&& loc_) {
-        if (std::regex_search(v_, std::regex(e_)) == neg_) {
-            fail_assertion(
-              std::forward_as_tuple(to_string(v_), (neg_ ? ns_like::NEG_CMP_STR : ns_like::CMP_STR), to_string(e_)),
-              loc_);
+        if (TPP_INTERN_UNLIKELY(std::regex_search(v_, std::regex(e_)) == neg_)) {
+            fail_comparison(operand_of(v_), neg_ ? ns_like::NEG_CMP_STR : ns_like::CMP_STR, operand_of(e_), loc_);
         }
     }
 };
@@ -104,9 +105,9 @@ TPP_PROVIDE_ASSERTION(assert_like, LIKE)
  * ASSERT_MATCH("hello", "hell(.*)"_re, m);
  * @endcode
  */
-#define ASSERT_MATCH(...)                                                   \
-    tpp::intern::assert::make_assertion<tpp::intern::assert::assert_match>( \
-      __VA_ARGS__, false, tpp::intern::assert::loc{__FILE__, __LINE__})
+#define ASSERT_MATCH(...)                                                                        \
+    TPP_INTERN_ASSERTION(tpp::intern::assert::make_assertion<tpp::intern::assert::assert_match>( \
+      __VA_ARGS__, false, tpp::intern::assert::loc{__FILE__, __LINE__}))
 
 /**
  * Assert a regex to not match a string.
@@ -119,9 +120,9 @@ TPP_PROVIDE_ASSERTION(assert_like, LIKE)
  * ASSERT_NOT_MATCH("hello world", "Hell.*"_re);
  * @endcode
  */
-#define ASSERT_NOT_MATCH(...)                                               \
-    tpp::intern::assert::make_assertion<tpp::intern::assert::assert_match>( \
-      __VA_ARGS__, true, tpp::intern::assert::loc{__FILE__, __LINE__})
+#define ASSERT_NOT_MATCH(...)                                                                    \
+    TPP_INTERN_ASSERTION(tpp::intern::assert::make_assertion<tpp::intern::assert::assert_match>( \
+      __VA_ARGS__, true, tpp::intern::assert::loc{__FILE__, __LINE__}))
 
 /**
  * Assert a regex to match a string partially.
@@ -138,9 +139,9 @@ TPP_PROVIDE_ASSERTION(assert_like, LIKE)
  * ASSERT_LIKE("hello", "he(.*)"_re, m);
  * @endcode
  */
-#define ASSERT_LIKE(...)                                                   \
-    tpp::intern::assert::make_assertion<tpp::intern::assert::assert_like>( \
-      __VA_ARGS__, false, tpp::intern::assert::loc{__FILE__, __LINE__})
+#define ASSERT_LIKE(...)                                                                        \
+    TPP_INTERN_ASSERTION(tpp::intern::assert::make_assertion<tpp::intern::assert::assert_like>( \
+      __VA_ARGS__, false, tpp::intern::assert::loc{__FILE__, __LINE__}))
 
 /**
  * Assert a regex to not match a string partially.
@@ -153,8 +154,8 @@ TPP_PROVIDE_ASSERTION(assert_like, LIKE)
  * ASSERT_NOT_LIKE("hello world", "He.*"_re);
  * @endcode
  */
-#define ASSERT_NOT_LIKE(...)                                               \
-    tpp::intern::assert::make_assertion<tpp::intern::assert::assert_like>( \
-      __VA_ARGS__, true, tpp::intern::assert::loc{__FILE__, __LINE__})
+#define ASSERT_NOT_LIKE(...)                                                                    \
+    TPP_INTERN_ASSERTION(tpp::intern::assert::make_assertion<tpp::intern::assert::assert_like>( \
+      __VA_ARGS__, true, tpp::intern::assert::loc{__FILE__, __LINE__}))
 
 #endif  // TPP_ASSERT_REGEX_HPP
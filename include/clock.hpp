@@ -0,0 +1,224 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_CLOCK_HPP
+#define TPP_CLOCK_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace tpp
+{
+namespace intern
+{
+namespace clock
+{
+/**
+ * The virtual time of a testcase. It runs along with the real time, but whenever all threads using it are sleeping,
+ * it is fast-forwarded to the earliest wakeup. Hence time-dependent code does not actually wait.
+ * The testcase itself uses it, further threads must join it by a scope, and leave before the testcase ends.
+ */
+class virtual_time final
+{
+public:
+    /**
+     * Use a virtual time in the current thread, instead of the previous one. A thread, that waits for others by other
+     * means than the clock, for example joins them, must leave the virtual time meanwhile by a scope of nullptr.
+     */
+    class scope final
+    {
+    public:
+        explicit scope(virtual_time* t_) : m_prev(current()) {
+            switch_to(m_prev, t_);
+        }
+
+        ~scope() noexcept {
+            switch_to(current(), m_prev);
+        }
+
+        scope(scope const&) = delete;
+        auto
+        operator=(scope const&) -> scope& = delete;
+
+    private:
+        static void
+        switch_to(virtual_time* from_, virtual_time* to_) {
+            if (from_) {
+                from_->leave();
+            }
+            current() = to_;
+            if (to_) {
+                to_->join();
+            }
+        }
+
+        virtual_time* m_prev;
+    };
+
+    virtual_time()                    = default;
+    virtual_time(virtual_time const&) = delete;
+    auto
+    operator=(virtual_time const&) -> virtual_time& = delete;
+
+    /// Get the virtual time of the current thread, or nullptr outside of testcases.
+    static auto
+    current() -> virtual_time*& {
+        static thread_local virtual_time* t{nullptr};
+        return t;
+    }
+
+    /// Get the amount of time, that was skipped so far.
+    inline auto
+    skipped() const -> std::chrono::nanoseconds {
+        return std::chrono::nanoseconds(m_skipped.load(std::memory_order_acquire));
+    }
+
+    void
+    sleep_for(std::chrono::nanoseconds d_) {
+        if (d_.count() <= 0) {
+            return;
+        }
+        std::unique_lock<std::mutex> lk(m_mtx);
+        auto const                   deadline{now() + d_};
+        auto const                   it{m_deadlines.insert(deadline)};
+        m_sleeping.fetch_add(1);
+        fast_forward();
+        while (now() < deadline) {
+            auto const wake{std::chrono::duration_cast<std::chrono::steady_clock::duration>(deadline - skipped())};
+            m_cv.wait_until(lk, std::chrono::steady_clock::time_point(wake));
+        }
+        m_sleeping.fetch_sub(1);
+        m_deadlines.erase(it);
+    }
+
+private:
+    /// Get the virtual time as offset to the epoch of the steady clock.
+    auto
+    now() const -> std::chrono::nanoseconds {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::steady_clock::now().time_since_epoch()) +
+               skipped();
+    }
+
+    /// Skip time up to the earliest deadline, if all threads are sleeping. The mutex must be held.
+    void
+    fast_forward() {
+        if (m_deadlines.empty() || m_deadlines.size() < m_threads.load()) {
+            return;
+        }
+        auto const gap{*m_deadlines.begin() - now()};
+        if (gap.count() > 0) {
+            m_skipped.fetch_add(gap.count(), std::memory_order_acq_rel);
+            m_cv.notify_all();
+        }
+    }
+
+    /**
+     * Joining, and leaving threads take the mutex only, if any thread is sleeping. Both the counters are sequentially
+     * consistent, hence either a leaving thread sees a sleeper, or the sleeper sees the decremented thread count.
+     */
+    void
+    join() {
+        m_threads.fetch_add(1);
+    }
+
+    void
+    leave() {
+        m_threads.fetch_sub(1);
+        if (m_sleeping.load() != 0) {
+            std::lock_guard<std::mutex> lk(m_mtx);
+            fast_forward();
+        }
+    }
+
+    std::mutex                              m_mtx;
+    std::condition_variable                 m_cv;
+    std::multiset<std::chrono::nanoseconds> m_deadlines;
+    std::atomic<std::size_t>                m_threads{0};
+    std::atomic<std::size_t>                m_sleeping{0};  ///< Number of threads in sleep_for.
+    std::atomic<std::int64_t>               m_skipped{0};
+};
+
+/**
+ * A clock, that follows the virtual time inside testcases, and the real clock B elsewhere.
+ * It satisfies the Clock requirements, and additionally provides sleep functions, that respect virtual time.
+ */
+template<typename B>
+class basic_clock final
+{
+public:
+    using rep                       = typename B::rep;
+    using period                    = typename B::period;
+    using duration                  = typename B::duration;
+    using time_point                = std::chrono::time_point<basic_clock>;
+    static constexpr bool is_steady = B::is_steady;
+
+    static auto
+    now() -> time_point {
+        auto const* t{virtual_time::current()};
+        return time_point(B::now().time_since_epoch() +
+                          (t ? std::chrono::duration_cast<duration>(t->skipped()) : duration::zero()));
+    }
+
+    template<typename R, typename P>
+    static void
+    sleep_for(std::chrono::duration<R, P> const& d_) {
+        auto* t{virtual_time::current()};
+        if (t) {
+            t->sleep_for(std::chrono::duration_cast<std::chrono::nanoseconds>(d_));
+        } else {
+            std::this_thread::sleep_for(d_);
+        }
+    }
+
+    template<typename D>
+    static void
+    sleep_until(std::chrono::time_point<basic_clock, D> const& tp_) {
+        sleep_for(tp_ - now());
+    }
+};
+
+template<typename B>
+constexpr bool basic_clock<B>::is_steady;
+}  // namespace clock
+}  // namespace intern
+
+namespace clock
+{
+/// Steady clock, which is fast-forwarded inside testcases, whenever all threads of a testcase are sleeping.
+using steady = intern::clock::basic_clock<std::chrono::steady_clock>;
+/// System clock, which is fast-forwarded inside testcases, whenever all threads of a testcase are sleeping.
+using system = intern::clock::basic_clock<std::chrono::system_clock>;
+/// Handle of the virtual time of a testcase, which can be passed to further threads.
+using context = intern::clock::virtual_time*;
+/// Scope, in which a thread uses the virtual time of a testcase.
+using scope = intern::clock::virtual_time::scope;
+
+/// Get the virtual time of the current testcase, to use it in further threads by a scope.
+inline auto
+current() -> context {
+    return intern::clock::virtual_time::current();
+}
+}  // namespace clock
+}  // namespace tpp
+
+#endif  // TPP_CLOCK_HPP
@@ -20,10 +20,14 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
+#include <string>
 
 #include "config.hpp"
+#include "fatal.hpp"
 #include "version.hpp"
 
 namespace tpp
@@ -40,13 +44,12 @@ public:
     parse(std::size_t argc_, char const** argv_) {
         auto const args{tokenize_args(argc_, argv_)};
         m_progname = argv_[0];
-        for (auto i{1UL}; i < args.size(); ++i) {
+        for (auto i{1UL}; i < args.size() && !m_help; ++i) {
             eval_arg(args[i], [&](std::string const& arg_) -> std::string const& {
-                try {
-                    return args.at(++i);
-                } catch (std::out_of_range const&) {
-                    throw std::runtime_error(arg_ + " requires an argument!");
+                if (++i >= args.size()) {
+                    TPP_INTERN_THROW(std::runtime_error(arg_ + " requires an argument!"));
                 }
+                return args[i];
             });
         }
     }
@@ -56,10 +59,13 @@ public:
         return m_cfg;
     }
 
-private:
-    struct matched
-    {};
+    /// Check whether the help was printed, hence nothing shall be run.
+    inline auto
+    help() const -> bool {
+        return m_help;
+    }
 
+private:
     template<typename T>
     struct option
     {
@@ -67,12 +73,12 @@ private:
 
         template<typename Arg, typename Fn>
         auto
-        operator()(Arg&& arg_, Fn&& fn_) const -> decltype(*this)& {
+        operator()(Arg&& arg_, Fn&& fn_) const -> bool {
             if (arg_ == m_flag) {
                 fn_();
-                throw matched{};
+                return true;
             }
-            return *this;
+            return false;
         }
     };
 
@@ -80,45 +86,79 @@ private:
     {
         template<typename Fn>
         auto
-        operator()(std::string const& arg_, Fn&& fn_) const -> decltype(*this)& {
+        operator()(std::string const& arg_, Fn&& fn_) const -> bool {
             if (arg_[0] == '-') {
-                std::for_each(arg_.cbegin() + 1, arg_.cend(), [&](char c_) {
-                    try {
-                        fn_(c_);
-                    } catch (matched) {
-                    }
-                });
-                throw matched{};
+                std::for_each(arg_.cbegin() + 1, arg_.cend(), std::forward<Fn>(fn_));
+                return true;
             }
-            return *this;
+            return false;
         }
     };
 
     template<typename Fn>
     void
     eval_arg(std::string const& arg_, Fn&& getval_fn_) {
-        try {
-            make_option(+"--help")(arg_, [&] { print_help(); });
-            make_option(+"--xml")(arg_, [&] { m_cfg.report_fmt = config::report_format::XML; });
-            make_option(+"--md")(arg_, [&] { m_cfg.report_fmt = config::report_format::MD; });
-            make_option(+"--json")(arg_, [&] { m_cfg.report_fmt = config::report_format::JSON; });
-            combined_option{}(arg_, [&](char c_) {
-                make_option('c')(c_, [&] { m_cfg.report_cfg.color = true; });
-                make_option('o')(c_, [&] { m_cfg.report_cfg.capture_out = true; });
-                make_option('s')(c_, [&] { m_cfg.report_cfg.strip = true; });
-                make_option('e')(c_, [&] {
-                    set_filter_mode(config::filter_mode::EXCLUDE);
-                    m_cfg.f_patterns.push_back(to_regex(getval_fn_(arg_)));
-                });
+        bool const matched{
+          make_option(+"--help")(arg_, [&] { print_help(); }) ||
+          make_option(+"--xml")(arg_, [&] { m_cfg.report_fmt = config::report_format::XML; }) ||
+          make_option(+"--md")(arg_, [&] { m_cfg.report_fmt = config::report_format::MD; }) ||
+          make_option(+"--json")(arg_, [&] { m_cfg.report_fmt = config::report_format::JSON; }) ||
+          make_option(+"--gen-report")(arg_, [&] { m_cfg.run_cfg.gen_policy = to_gen_policy(getval_fn_(arg_)); }) ||
+          make_option(+"--serve")(arg_,
+                                  [&] {
+                                      set_dist_mode(config::dist_mode::SERVE);
+                                      auto const addr{getval_fn_(arg_)};
+                                      if (addr.find(':') == std::string::npos) {
+                                          m_cfg.dist_port = to_port(addr);
+                                      } else {
+                                          set_address(addr);
+                                      }
+                                  }) ||
+          make_option(+"--worker")(arg_,
+                                   [&] {
+                                       set_dist_mode(config::dist_mode::WORKER);
+                                       set_address(getval_fn_(arg_));
+                                   }) ||
+          make_option(+"--journal")(arg_, [&] { m_cfg.journal = getval_fn_(arg_); }) ||
+          make_option(+"--resume")(arg_,
+                                   [&] {
+                                       m_cfg.journal = getval_fn_(arg_);
+                                       m_cfg.resume  = true;
+                                   }) ||
+          make_option(+"--load")(arg_, [&] { m_cfg.modules.push_back(getval_fn_(arg_)); }) ||
+          make_option(+"--watch")(arg_, [&] { m_cfg.watch = true; }) ||
+          make_option(+"--retries")(arg_, [&] { m_cfg.run_cfg.retries = to_count(getval_fn_(arg_)); }) ||
+          make_option(+"--quarantine")(arg_, [&] { m_cfg.quarantine = getval_fn_(arg_); }) ||
+          make_option(+"--seed")(arg_,
+                                 [&] {
+                                     m_cfg.seed   = to_seed(getval_fn_(arg_));
+                                     m_cfg.seeded = true;
+                                 }) ||
+          make_option(+"--keep-temp")(arg_, [&] { m_cfg.keep_temp = true; }) ||
+          make_option(+"--group-fixtures")(arg_, [&] { m_cfg.group_fixtures = true; }) ||
+          make_option(+"--fork")(arg_, [&] { m_cfg.isolate = true; }) ||
+          make_option(+"--startup-profile")(arg_, [&] { m_cfg.startup_profile = true; }) ||
+          make_option(+"--list")(arg_, [&] { m_cfg.list = true; }) ||
+          make_option(+"--coverage-map")(arg_, [&] { m_cfg.coverage_map = getval_fn_(arg_); }) ||
+          make_option(+"--changed-files")(arg_, [&] { add_changed_files(getval_fn_(arg_)); }) ||
+          combined_option{}(arg_, [&](char c_) {
+              static_cast<void>(
+                make_option('c')(c_, [&] { m_cfg.report_cfg.color = true; }) ||
+                make_option('o')(c_, [&] { m_cfg.report_cfg.capture_out = true; }) ||
+                make_option('s')(c_, [&] { m_cfg.report_cfg.strip = true; }) ||
+                make_option('e')(c_,
+                                 [&] {
+                                     set_filter_mode(config::filter_mode::EXCLUDE);
+                                     m_cfg.f_patterns.push_back(to_regex(getval_fn_(arg_)));
+                                 }) ||
                 make_option('i')(c_, [&] {
                     set_filter_mode(config::filter_mode::INCLUDE);
                     m_cfg.f_patterns.push_back(to_regex(getval_fn_(arg_)));
-                });
-            });
-        } catch (matched) {
-            return;
+                }));
+          })};
+        if (!matched) {
+            m_cfg.report_cfg.outfile = arg_;
         }
-        m_cfg.report_cfg.outfile = arg_;
     }
 
     template<typename T>
@@ -138,6 +178,37 @@ private:
                      "  --xml : Report in JUnit-like XML format.\n"
                      "  --md  : Report in markdown format.\n"
                      "  --json: Report in json format.\n"
+                     "  --gen-report <policy> : Report generated testcases according to policy, which is one of\n"
+                     "                          all, failed (default), or aggregate.\n"
+                     "  --serve <[host:]port> : Distribute testcases to workers, which connect at port.\n"
+                     "                          Only local workers can connect, unless the host to listen on is\n"
+                     "                          given, e.g. [::] for all interfaces.\n"
+                     "  --worker <host:port>  : Run testcases as worker for the coordinator at host:port.\n"
+                     "                          The worker must be the same binary as the coordinator.\n"
+                     "  --journal <file>      : Record results in a journal file, which survives crashes.\n"
+                     "  --resume <file>       : Resume a run from its journal file, and continue recording to it.\n"
+                     "                          Recorded testcases are not run again, but reported.\n"
+                     "  --load <module>       : Load testsuites from a shared library module.\n"
+                     "                          Multiple modules are possible, they all run in this process.\n"
+                     "  --watch               : Keep running, and rerun the testsuites of a module, whenever it is\n"
+                     "                          rebuilt. Global fixtures are kept alive across reloads.\n"
+                     "  --retries <n>         : Rerun failed testcases up to n times after all testsuites were run.\n"
+                     "                          Testcases that pass on a retry are reported as flaky.\n"
+                     "  --quarantine <file>   : Do not count failures of testcases listed in file for the exit code.\n"
+                     "                          Each line is a pattern suite/testcase, where * is a wildcard.\n"
+                     "  --seed <n>            : Seed random numbers of tpp::rng() with n, which is random by default.\n"
+                     "  --keep-temp           : Keep the temporary directories of unsuccessful testcases.\n"
+                     "  --group-fixtures      : Run testsuites, that share a global fixture, right after each other.\n"
+                     "  --fork                : Run each testcase in a child process, which is forked after SETUP of\n"
+                     "                          its testsuite, so that it sees pristine fixtures.\n"
+                     "  --startup-profile     : Print how many testsuites were registered statically, and how long\n"
+                     "                          creating them took to stderr.\n"
+                     "  --list                : List all selected testcases with their source location, and exit.\n"
+                     "                          Nothing is run, the format is json, if --json is given.\n"
+                     "  --coverage-map <file> : Run testcases one by one, and record which source files each of them\n"
+                     "                          executes in file. Requires a build with --coverage and TPP_COVERAGE.\n"
+                     "  --changed-files <list>: Run only testcases, that executed any of the comma separated files,\n"
+                     "                          according to the map given by --coverage-map.\n"
                      "  -c    : Use ANSI colors in report, if supported by reporter.\n"
                      "  -s    : Strip unnecessary whitespaces from report.\n"
                      "  -o    : Report captured output from tests, if supported by reporter.\n\n"
@@ -146,13 +217,16 @@ private:
                      "  -e <pattern> : Exclude testsuites with names matching pattern.\n"
                      "  -i <pattern> : Include only testsuites with names matching pattern."
                   << std::endl;
+        m_help = true;
+#ifndef TPP_INTERN_NO_EXCEPTIONS
         throw help_called{};
+#endif
     }
 
     static auto
     tokenize_args(std::size_t argc_, char const** argv_) -> std::vector<std::string> {
         if (argc_ == 0) {
-            throw std::runtime_error("Too few arguments!");
+            TPP_INTERN_THROW(std::runtime_error("Too few arguments!"));
         }
         std::vector<std::string> a;
         a.reserve(argc_);
@@ -170,22 +244,113 @@ private:
         if (m_cfg.f_mode == config::filter_mode::NONE) {
             m_cfg.f_mode = m_;
         } else if (m_cfg.f_mode != m_) {
-            throw std::runtime_error("Inclusion and exclusion are mutually exclusive!");
+            TPP_INTERN_THROW(std::runtime_error("Inclusion and exclusion are mutually exclusive!"));
+        }
+    }
+
+    void
+    set_dist_mode(config::dist_mode m_) {
+        if (m_cfg.dist != config::dist_mode::LOCAL && m_cfg.dist != m_) {
+            TPP_INTERN_THROW(std::runtime_error("Serving and working are mutually exclusive!"));
+        }
+        m_cfg.dist = m_;
+    }
+
+    void
+    set_address(std::string const& str_) {
+        auto const pos{str_.rfind(':')};
+        if (pos == std::string::npos || pos == 0) {
+            TPP_INTERN_THROW(std::runtime_error(str_ + " is not a valid address!"));
+        }
+        m_cfg.dist_host = str_.substr(0, pos);
+        if (m_cfg.dist_host.size() > 2 && m_cfg.dist_host.front() == '[' && m_cfg.dist_host.back() == ']') {
+            m_cfg.dist_host = m_cfg.dist_host.substr(1, m_cfg.dist_host.size() - 2);
+        }
+        m_cfg.dist_port = to_port(str_.substr(pos + 1));
+    }
+
+    static auto
+    to_port(std::string const& str_) -> std::uint16_t {
+        if (str_.empty() || str_.size() > 5 ||
+            !std::all_of(str_.cbegin(), str_.cend(), [](char c_) { return c_ >= '0' && c_ <= '9'; }) ||
+            std::stoul(str_) > 65535UL) {
+            TPP_INTERN_THROW(std::runtime_error(str_ + " is not a valid port!"));
+        }
+        return static_cast<std::uint16_t>(std::stoul(str_));
+    }
+
+    void
+    add_changed_files(std::string const& str_) {
+        m_cfg.impact = true;
+        std::size_t begin{0};
+        while (begin <= str_.size()) {
+            auto const end{std::min(str_.find(',', begin), str_.size())};
+            if (end > begin) {
+                m_cfg.changed_files.push_back(str_.substr(begin, end - begin));
+            }
+            begin = end + 1;
         }
     }
 
+    static auto
+    to_count(std::string const& str_) -> std::size_t {
+        if (str_.empty() || str_.size() > 9 ||
+            !std::all_of(str_.cbegin(), str_.cend(), [](char c_) { return c_ >= '0' && c_ <= '9'; })) {
+            TPP_INTERN_THROW(std::runtime_error(str_ + " is not a valid count!"));
+        }
+        return static_cast<std::size_t>(std::stoul(str_));
+    }
+
+    static auto
+    to_seed(std::string const& str_) -> std::uint64_t {
+        auto const    max{std::numeric_limits<std::uint64_t>::max()};
+        std::uint64_t seed{0};
+        auto          valid{!str_.empty()};
+        for (auto c : str_) {
+            if (c < '0' || c > '9' || seed > (max - static_cast<std::uint64_t>(c - '0')) / 10) {
+                valid = false;
+                break;
+            }
+            seed = seed * 10 + static_cast<std::uint64_t>(c - '0');
+        }
+        if (!valid) {
+            TPP_INTERN_THROW(std::runtime_error(str_ + " is not a valid seed!"));
+        }
+        return seed;
+    }
+
     static auto
     to_regex(std::string const& str_) -> std::regex {
+#ifdef TPP_INTERN_NO_EXCEPTIONS
+        return std::regex(std::regex_replace(str_, std::regex("\\*"), ".*"),
+                          std::regex_constants::nosubs | std::regex_constants::basic);
+#else
         try {
             return std::regex(std::regex_replace(str_, std::regex("\\*"), ".*"),
                               std::regex_constants::nosubs | std::regex_constants::basic);
         } catch (std::regex_error const&) {
             throw std::runtime_error(str_ + " is not a valid pattern!");
         }
+#endif
+    }
+
+    static auto
+    to_gen_policy(std::string const& str_) -> test::generator_policy {
+        if (str_ == "all") {
+            return test::generator_policy::ALL;
+        }
+        if (str_ == "failed") {
+            return test::generator_policy::FAILED;
+        }
+        if (str_ == "aggregate") {
+            return test::generator_policy::AGGREGATE;
+        }
+        TPP_INTERN_THROW(std::runtime_error(str_ + " is not a valid generator report policy!"));
     }
 
     struct config m_cfg;
     char const*   m_progname{nullptr};
+    bool          m_help{false};
 };
 }  // namespace intern
 }  // namespace tpp
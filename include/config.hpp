@@ -18,7 +18,10 @@
 #ifndef TPP_CONFIG_HPP
 #define TPP_CONFIG_HPP
 
+#include <algorithm>
+#include <cstdint>
 #include <regex>
+#include <string>
 #include <vector>
 
 #include "report/console_reporter.hpp"
@@ -26,6 +29,7 @@
 #include "report/markdown_reporter.hpp"
 #include "report/reporter_factory.hpp"
 #include "report/xml_reporter.hpp"
+#include "test/run_config.hpp"
 
 namespace tpp
 {
@@ -48,6 +52,13 @@ struct config
         CNS
     };
 
+    enum class dist_mode
+    {
+        LOCAL,
+        SERVE,
+        WORKER
+    };
+
     auto
     reporter() const -> reporter_ptr {
         switch (report_fmt) {
@@ -58,10 +69,38 @@ struct config
         }
     }
 
-    report_format           report_fmt{report_format::CNS};
-    report::reporter_config report_cfg;
-    std::vector<std::regex> f_patterns;
-    filter_mode             f_mode{filter_mode::NONE};
+    /// Check whether a testsuite is selected by the filters.
+    auto
+    selects(char const* name_) const -> bool {
+        bool const match{f_patterns.empty() ||
+                         std::any_of(f_patterns.cbegin(), f_patterns.cend(),
+                                     [&](std::regex const& re_) -> bool { return std::regex_match(name_, re_); })};
+        return (f_mode != filter_mode::EXCLUDE) == match;
+    }
+
+    report_format            report_fmt{report_format::CNS};
+    report::reporter_config  report_cfg;
+    test::run_config         run_cfg;
+    std::vector<std::regex>  f_patterns;
+    filter_mode              f_mode{filter_mode::NONE};
+    dist_mode                dist{dist_mode::LOCAL};
+    std::string              dist_host;  ///< Host to listen on, or to connect to. Serving on loopback if empty.
+    std::uint16_t            dist_port{0};
+    std::vector<std::string> modules;
+    std::string              journal;
+    std::string              quarantine;
+    std::string              coverage_map;
+    std::vector<std::string> changed_files;
+    bool                     resume{false};
+    bool                     watch{false};
+    bool                     impact{false};  ///< Whether only testcases affected by changed_files are run.
+    bool                     keep_temp{false};
+    bool                     isolate{false};  ///< Whether each testcase runs in a process forked after SETUP.
+    bool                     group_fixtures{false};  ///< Whether testsuites sharing global fixtures run in a row.
+    bool                     startup_profile{false};  ///< Whether the time of registering testsuites is printed.
+    bool                     list{false};  ///< Whether testcases are only listed, without creating testsuites.
+    bool                     seeded{false};  ///< Whether the global seed is set, rather than random.
+    std::uint64_t            seed{0};
 };
 }  // namespace intern
 
@@ -0,0 +1,327 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_COVERAGE_HPP
+#define TPP_COVERAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cpp_meta.hpp"
+#include "fatal.hpp"
+
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+#    include <ftw.h>
+#    include <unistd.h>
+#endif
+
+#if defined(TPP_INTERN_HAS_SYS_FEATURES) && defined(TPP_COVERAGE)
+extern "C" void
+__gcov_dump();
+extern "C" void
+__gcov_reset();
+#endif
+
+namespace tpp
+{
+namespace intern
+{
+/**
+ * A map from testcases to the source files, which they executed. Testcases are named by their testsuite and declared
+ * name, separated by a slash. Source files are the objects, that coverage data was recorded for.
+ */
+class coverage_map
+{
+public:
+    /// Read a map, that was written by save.
+    static auto
+    load(std::string const& path_) -> coverage_map {
+        std::ifstream in(path_);
+        std::string   line;
+        if (!in || !std::getline(in, line) || line != header()) {
+            TPP_INTERN_THROW(std::runtime_error(path_ + " is not a coverage map"));
+        }
+        coverage_map m;
+        while (std::getline(in, line)) {
+            auto const tab{line.find('\t', 2)};
+            if (line.compare(0, 2, "F\t") == 0) {
+                m.file_index(line.substr(2));
+            } else if (line.compare(0, 2, "T\t") == 0 && tab != std::string::npos) {
+                auto&              files{m.m_tests[line.substr(2, tab - 2)]};
+                std::istringstream idx(line.substr(tab + 1));
+                std::size_t        i;
+                while (idx >> i) {
+                    if (i >= m.m_files.size()) {
+                        TPP_INTERN_THROW(std::runtime_error(path_ + " is not a coverage map"));
+                    }
+                    files.insert(i);
+                }
+            } else {
+                TPP_INTERN_THROW(std::runtime_error(path_ + " is not a coverage map"));
+            }
+        }
+        return m;
+    }
+
+    void
+    save(std::string const& path_) const {
+        std::ofstream out(path_);
+        out << header() << '\n';
+        for (auto const& f : m_files) {
+            out << "F\t" << f << '\n';
+        }
+        for (auto const& t : m_tests) {
+            out << "T\t" << t.first << '\t';
+            for (auto i : t.second) {
+                out << i << ' ';
+            }
+            out << '\n';
+        }
+        if (!out.flush()) {
+            TPP_INTERN_THROW(std::runtime_error("could not write coverage map " + path_));
+        }
+    }
+
+    /// Add the files, that a testcase executed. Multiple records of the same testcase are merged.
+    void
+    record(std::string const& test_, std::vector<std::string> const& files_) {
+        auto& files{m_tests[test_]};
+        for (auto const& f : files_) {
+            files.insert(file_index(f));
+        }
+    }
+
+    /**
+     * Get the testcases, that executed any of the changed files. A changed file matches a source file in the map, if it
+     * is a suffix of its path. The extension of a changed C, or C++ file may be missing in the map, as for objects
+     * named like a.o instead of a.cpp.o.
+     * @return false, if any changed file is not in the map, hence it is unknown which testcases it affects.
+     */
+    auto
+    affected(std::vector<std::string> const& changed_, std::set<std::string>& tests_) const -> bool {
+        std::set<std::size_t> hit;
+        for (auto const& c : changed_) {
+            auto found{false};
+            for (std::size_t i{0}; i < m_files.size(); ++i) {
+                if (matches(m_files[i], c)) {
+                    hit.insert(i);
+                    found = true;
+                }
+            }
+            if (!found) {
+                return false;
+            }
+        }
+        for (auto const& t : m_tests) {
+            for (auto i : t.second) {
+                if (hit.count(i) > 0) {
+                    tests_.insert(t.first);
+                    break;
+                }
+            }
+        }
+        return true;
+    }
+
+    /// Check whether a testcase is in the map. Testcases, that were added after the map was recorded, are not.
+    auto
+    contains(std::string const& test_) const -> bool {
+        return m_tests.count(test_) > 0;
+    }
+
+private:
+    static auto
+    header() -> char const* {
+        return "tpp-coverage-map 1";
+    }
+
+    auto
+    file_index(std::string const& file_) -> std::size_t {
+        auto const it{m_index.find(file_)};
+        if (it != m_index.end()) {
+            return it->second;
+        }
+        m_files.push_back(file_);
+        return m_index[file_] = m_files.size() - 1;
+    }
+
+    static auto
+    ends_with(std::string const& str_, std::string const& sfx_) -> bool {
+        return str_.size() >= sfx_.size() && str_.compare(str_.size() - sfx_.size(), sfx_.size(), sfx_) == 0 &&
+               (str_.size() == sfx_.size() || str_[str_.size() - sfx_.size() - 1] == '/');
+    }
+
+    static auto
+    matches(std::string const& file_, std::string const& changed_) -> bool {
+        auto const c{changed_.compare(0, 2, "./") == 0 ? changed_.substr(2) : changed_};
+        auto const dot{c.rfind('.')};
+        auto const ext{dot != std::string::npos ? c.substr(dot) : std::string()};
+        auto const is_src{ext == ".c" || ext == ".cc" || ext == ".cpp" || ext == ".cxx"};
+        return ends_with(file_, c) || (is_src && ends_with(file_, c.substr(0, dot)));
+    }
+
+    std::vector<std::string>                     m_files;
+    std::map<std::string, std::size_t>           m_index;
+    std::map<std::string, std::set<std::size_t>> m_tests;
+};
+
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+/**
+ * Collect, which source files were executed in between two points in time, from the coverage counters of libgcov.
+ * Counters are dumped into a temporary directory by redirecting them with GCOV_PREFIX, and reset afterwards.
+ * This requires the binary to be built with --coverage, and TPP_COVERAGE to be defined.
+ */
+class coverage_probe
+{
+public:
+    coverage_probe(coverage_probe const&)     = delete;
+    coverage_probe(coverage_probe&&) noexcept = delete;
+    auto
+    operator=(coverage_probe const&) -> coverage_probe& = delete;
+    auto
+    operator=(coverage_probe&&) noexcept -> coverage_probe& = delete;
+
+    coverage_probe() : m_dir("/tmp/tpp-coverage-" + std::to_string(::getpid())) {
+#    ifndef TPP_COVERAGE
+        throw std::runtime_error("coverage maps require a build with --coverage, and TPP_COVERAGE defined");
+#    endif
+    }
+
+    ~coverage_probe() noexcept {
+        clear();
+    }
+
+    /// Discard all counters, so that the next collection covers only what is executed from now on.
+    void
+    reset() {
+#    ifdef TPP_COVERAGE
+        ::__gcov_reset();
+#    endif
+    }
+
+    /// Get the source files, that were executed since the last reset, and reset the counters.
+    auto
+    collect() -> std::vector<std::string> {
+        std::vector<std::string> files;
+#    ifdef TPP_COVERAGE
+        auto const* prev{std::getenv("GCOV_PREFIX")};
+        auto const  prev_val{prev ? std::string(prev) : std::string()};
+        ::setenv("GCOV_PREFIX", m_dir.c_str(), 1);
+        ::__gcov_dump();
+        if (prev) {
+            ::setenv("GCOV_PREFIX", prev_val.c_str(), 1);
+        } else {
+            ::unsetenv("GCOV_PREFIX");
+        }
+        ::__gcov_reset();
+        collected() = &files;
+        ::nftw(m_dir.c_str(), &coverage_probe::visit, 16, FTW_PHYS);
+        collected() = nullptr;
+        for (auto& f : files) {
+            f = f.substr(m_dir.size(), f.size() - m_dir.size() - 5);
+        }
+        clear();
+#    endif
+        return files;
+    }
+
+private:
+    static constexpr std::uint32_t GCDA_MAGIC = 0x67636461;
+    static constexpr std::uint32_t TAG_ARCS   = 0x01a10000;
+
+    static auto
+    collected() -> std::vector<std::string>*& {
+        static std::vector<std::string>* files{nullptr};
+        return files;
+    }
+
+    static auto
+    visit(char const* path_, struct stat const*, int type_, struct FTW*) -> int {
+        std::string const p(path_);
+        if (type_ == FTW_F && p.size() > 5 && p.compare(p.size() - 5, 5, ".gcda") == 0 && executed(p)) {
+            collected()->push_back(p);
+        }
+        return 0;
+    }
+
+    /**
+     * Check whether any arc counter in a gcda file is not zero. Since GCC 12 record lengths are given in bytes, a
+     * negative length denotes all counters being zero, and the header contains a checksum.
+     */
+    static auto
+    executed(std::string const& path_) -> bool {
+        std::ifstream in(path_, std::ios::binary);
+        std::uint32_t hdr[3]{};
+        if (!in.read(reinterpret_cast<char*>(hdr), sizeof(hdr)) || hdr[0] != GCDA_MAGIC) {
+            return false;
+        }
+        auto const c0{static_cast<char>(hdr[1] >> 24)};
+        auto const major{c0 >= 'A' ? (c0 - 'A') * 10 + (static_cast<char>(hdr[1] >> 16) - '0') : c0 - '0'};
+        if (major >= 12) {
+            in.ignore(4);
+        }
+        std::uint32_t rec[2];
+        while (in.read(reinterpret_cast<char*>(rec), sizeof(rec))) {
+            auto const len{static_cast<std::int32_t>(rec[1])};
+            if (len <= 0) {
+                continue;
+            }
+            auto const bytes{major >= 12 ? static_cast<std::size_t>(len) : static_cast<std::size_t>(len) * 4};
+            if (rec[0] != TAG_ARCS) {
+                in.ignore(static_cast<std::streamsize>(bytes));
+                continue;
+            }
+            std::vector<std::uint64_t> counters(bytes / 8);
+            if (!in.read(reinterpret_cast<char*>(counters.data()), static_cast<std::streamsize>(counters.size() * 8))) {
+                return false;
+            }
+            for (auto n : counters) {
+                if (n != 0) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    static auto
+    remove(char const* path_, struct stat const*, int, struct FTW*) -> int {
+        return std::remove(path_);
+    }
+
+    /// Remove all dumped coverage data.
+    void
+    clear() noexcept {
+        ::nftw(m_dir.c_str(), &coverage_probe::remove, 16, FTW_DEPTH | FTW_PHYS);
+    }
+
+    std::string const m_dir;
+};
+#endif
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_COVERAGE_HPP
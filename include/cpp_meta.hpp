@@ -38,6 +38,13 @@
 
 #endif
 
+#if defined(TPP_INTERN_CPP_V17) && defined(__has_include)
+#    if __has_include(<memory_resource>)
+/// Polymorphic memory resources (std::pmr) are available
+#        define TPP_INTERN_HAS_PMR
+#    endif
+#endif
+
 #if defined(__GNUG__) || defined(__clang__)
 /// UNIX system (gcc/clang)
 #    define TPP_INTERN_SYS_UNIX
@@ -52,6 +59,36 @@
 
 #endif
 
+#if !defined(__cpp_exceptions) && !defined(__EXCEPTIONS) && !defined(_CPPUNWIND)
+/// Exceptions are disabled (-fno-exceptions), hence assertions leave testcases by return, and fatal errors abort.
+#    define TPP_INTERN_NO_EXCEPTIONS
+#endif
+
+#if defined(__linux__)
+/// Linux system, where POSIX sockets and processes are available
+#    define TPP_INTERN_SYS_LINUX
+#endif
+
+#if defined(TPP_INTERN_SYS_LINUX) && !defined(TPP_INTERN_NO_EXCEPTIONS)
+/// Features using POSIX sockets and processes are available, as they report errors by exceptions.
+#    define TPP_INTERN_HAS_SYS_FEATURES
+#elif defined(TPP_INTERN_SYS_LINUX)
+/// Why features using POSIX sockets and processes are not available.
+#    define TPP_INTERN_NO_SYS_FEATURES "not supported without exceptions"
+#else
+#    define TPP_INTERN_NO_SYS_FEATURES "not supported on this platform"
+#endif
+
+#if defined(TPP_INTERN_SYS_UNIX)
+/// Mark a function as rarely called, so that it is neither inlined, nor placed among hot code.
+#    define TPP_INTERN_COLD __attribute__((cold, noinline))
+/// Hint a condition to be false in general.
+#    define TPP_INTERN_UNLIKELY(C) __builtin_expect(static_cast<bool>(C), 0)
+#else
+#    define TPP_INTERN_COLD __declspec(noinline)
+#    define TPP_INTERN_UNLIKELY(C) (C)
+#endif
+
 // Experimental feature, that allows atomic blocks.
 // Can be enabled by -fgnu-tm in gcc.
 #if __cpp_transactional_memory >= 201505
@@ -20,22 +20,73 @@
 
 #include <chrono>
 
+#include "clock.hpp"
+
 namespace tpp
 {
 namespace intern
 {
-class duration final
+/// Measure elapsed time according to the clock C.
+template<typename C>
+class basic_duration final
 {
 public:
-    duration() : m_start(std::chrono::steady_clock::now()) {}
+    basic_duration() : m_start(C::now()) {}
 
     auto
     get() -> double {
-        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+        return std::chrono::duration<double, std::milli>(C::now() - m_start).count();
+    }
+
+private:
+    typename C::time_point const m_start;
+};
+
+/// Measure real time.
+using duration = basic_duration<std::chrono::steady_clock>;
+/// Measure virtual time, which includes the time skipped by the clock of the current testcase.
+using virtual_duration = basic_duration<clock::basic_clock<std::chrono::steady_clock>>;
+
+/**
+ * Measure consecutive laps of real time, where a lap starts at the end of the previous one. Hence a lap needs a single
+ * read of the clock, and the work in between two laps is attributed to the latter. Unless laps are chained, or after
+ * an interruption, a lap starts at its own read of the clock.
+ */
+class lap_timer final
+{
+public:
+    using time_point = std::chrono::steady_clock::time_point;
+
+    explicit lap_timer(bool chained_) : m_chained(chained_) {}
+
+    auto
+    start() const -> time_point {
+        return m_running ? m_last : std::chrono::steady_clock::now();
+    }
+
+    /// End the lap, that was started at start_, and get its duration in milliseconds.
+    auto
+    stop(time_point start_) -> double {
+        auto const now{std::chrono::steady_clock::now()};
+        if (m_chained) {
+            m_last    = now;
+            m_running = true;
+        }
+        return std::chrono::duration<double, std::milli>(now - start_).count();
+    }
+
+    /// Let the next lap start at its own read of the clock, because something else than bookkeeping happens before.
+    inline void
+    interrupt() {
+        if (m_chained) {
+            m_running = false;
+        }
     }
 
 private:
-    std::chrono::steady_clock::time_point const m_start;
+    bool const m_chained;
+    bool       m_running{false};
+    time_point m_last;
 };
 }  // namespace intern
 }  // namespace tpp
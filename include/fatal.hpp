@@ -0,0 +1,46 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_FATAL_HPP
+#define TPP_FATAL_HPP
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+
+#include "cpp_meta.hpp"
+
+namespace tpp
+{
+namespace intern
+{
+/// Report a fatal error, and abort. This replaces throwing it, if exceptions are disabled.
+[[noreturn]] inline void
+fatal(std::exception const& e_) noexcept {
+    std::cerr << "A fatal error occurred!\n  what(): " << e_.what() << std::endl;
+    std::abort();
+}
+}  // namespace intern
+}  // namespace tpp
+
+#ifdef TPP_INTERN_NO_EXCEPTIONS
+#    define TPP_INTERN_THROW(...) tpp::intern::fatal(__VA_ARGS__)
+#else
+#    define TPP_INTERN_THROW(...) throw __VA_ARGS__
+#endif
+
+#endif  // TPP_FATAL_HPP
@@ -0,0 +1,109 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_FIXTURES_HPP
+#define TPP_FIXTURES_HPP
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "test/dataset.hpp"
+#include "test/fixture_store.hpp"
+#include "test/testsuite.hpp"
+
+#include "registry.hpp"
+
+namespace tpp
+{
+namespace intern
+{
+/**
+ * Handle of a global fixture, that is declared by a testsuite with GLOBAL_FIXTURE. The fixture is default constructed
+ * on first use, and destroyed after the last testsuite, that declared it, has finished.
+ */
+template<typename T>
+class fixture_handle final
+{
+public:
+    fixture_handle(test::testsuite_ptr const& ts_, char const* name_) : m_name(name_) {
+        ts_->use_fixture(test::fixture_store::signature<T>(name_));
+    }
+
+    fixture_handle(fixture_handle const&) = delete;
+    auto
+    operator=(fixture_handle const&) -> fixture_handle& = delete;
+
+    auto
+    get() const -> T& {
+        return global_fixtures().obtain<T>(m_name, [] { return std::unique_ptr<T>(new T()); });
+    }
+
+    inline auto
+    operator*() const -> T& {
+        return get();
+    }
+
+    inline auto
+    operator->() const -> T* {
+        return &get();
+    }
+
+private:
+    char const* const m_name;
+};
+}  // namespace intern
+
+/**
+ * Get a global fixture, which is shared by all testsuites, and lives until the end of the test process.
+ * It is constructed on first use by make_, which returns a unique, or shared pointer to it.
+ * In watch mode fixtures are kept alive across reloads of modules, as long as their name and type signature (name,
+ * size, and alignment of the type) are unchanged.
+ *
+ * EXAMPLE:
+ * @code
+ * auto& db{tpp::global_fixture<database>("db", [] { return std::unique_ptr<database>(new database("test.db")); })};
+ * @endcode
+ */
+template<typename T, typename Fn>
+auto
+global_fixture(char const* name_, Fn&& make_) -> T& {
+    return intern::global_fixtures().obtain<T>(name_, std::forward<Fn>(make_));
+}
+
+/**
+ * Get a dataset, which is generated once per test process, and shared read-only by all testsuites.
+ * It is generated by make_, which returns a vector of trivially copyable elements. The elements are cached in a file,
+ * which is memory-mapped by later test processes, until the version of the generator changes. The cache directory is
+ * given by the environment variable TPP_CACHE.
+ *
+ * EXAMPLE:
+ * @code
+ * auto const& pts{tpp::dataset<point>("points", "v2", [] { return make_points(1000000); })};
+ * @endcode
+ */
+template<typename T, typename Fn>
+auto
+dataset(char const* key_, char const* version_, Fn&& make_) -> intern::test::dataset<T> const& {
+    return intern::global_fixtures().obtain<intern::test::dataset<T>>(key_, [&] {
+        return intern::test::dataset<T>::load(intern::test::dataset_file(key_), std::string(key_) + '\0' + version_,
+                                              make_);
+    });
+}
+}  // namespace tpp
+
+#endif  // TPP_FIXTURES_HPP
@@ -0,0 +1,245 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_ISOLATION_HPP
+#define TPP_ISOLATION_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "net/protocol.hpp"
+#include "test/run_config.hpp"
+#include "test/testsuite.hpp"
+#include "test/work_unit.hpp"
+
+#include "cpp_meta.hpp"
+
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+#    include <cerrno>
+#    include <csignal>
+#    include <cstring>
+#    include <fcntl.h>
+#    include <poll.h>
+#    include <sys/types.h>
+#    include <sys/wait.h>
+#    include <unistd.h>
+#endif
+
+namespace tpp
+{
+namespace intern
+{
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+/**
+ * Run each unit of work of a testsuite in a child process, that is forked after SETUP was run in this process.
+ * Hence every unit sees the fixtures of the testsuite as they were after SETUP, copy-on-write, and whatever it changes,
+ * or how it crashes, does not affect other units. Results are sent back through a pipe, and up to jobs_ children run
+ * at once. Children run their unit sequentially, as OpenMP can not be used after a fork. A child, that does not exit
+ * within timeout_, is killed.
+ */
+class fork_isolation final
+{
+public:
+    /// Number of generated cases, that run in the same child.
+    static constexpr std::size_t CHUNK = 64;
+
+    using clock = std::chrono::steady_clock;
+
+    fork_isolation(test::testsuite& ts_, test::run_config const& cfg_, std::size_t jobs_,
+                   clock::duration timeout_ = std::chrono::minutes(10))
+        : m_ts(ts_), m_cfg(cfg_), m_jobs(std::max<std::size_t>(1, jobs_)), m_timeout(timeout_) {}
+
+    fork_isolation(fork_isolation const&) = delete;
+    auto
+    operator=(fork_isolation const&) -> fork_isolation& = delete;
+
+    ~fork_isolation() noexcept {
+        for (auto& c : m_children) {
+            ::kill(c.pid, SIGKILL);
+            ::close(c.fd);
+            ::waitpid(c.pid, nullptr, 0);
+        }
+    }
+
+    /// Run all pending units of work, and complete the testsuite.
+    void
+    run() {
+        auto const units{m_ts.units(CHUNK)};
+        if (!units.empty()) {
+            m_ts.prepare_units();
+            for (auto const& u : units) {
+                while (m_children.size() >= m_jobs) {
+                    collect();
+                }
+                start(u);
+            }
+            while (!m_children.empty()) {
+                collect();
+            }
+            m_ts.finish_units();
+        }
+        m_ts.complete(m_cfg);
+    }
+
+private:
+    struct child
+    {
+        pid_t             pid;
+        int               fd;
+        test::work_unit   unit;
+        std::string       data;
+        clock::time_point deadline;
+    };
+
+    void
+    start(test::work_unit const& u_) {
+        int fds[2];
+        if (::pipe2(fds, O_CLOEXEC) != 0) {
+            throw std::runtime_error(std::string("could not create pipe: ") + std::strerror(errno));
+        }
+        std::cout.flush();
+        std::cerr.flush();
+        auto const pid{::fork()};
+        if (pid < 0) {
+            ::close(fds[0]);
+            ::close(fds[1]);
+            throw std::runtime_error(std::string("could not fork: ") + std::strerror(errno));
+        }
+        if (pid == 0) {
+            ::close(fds[0]);
+            run_child(u_, fds[1]);
+        }
+        ::close(fds[1]);
+        m_children.push_back(child{pid, fds[0], u_, std::string(), clock::now() + m_timeout});
+    }
+
+    /// Run a unit of work in the child process, write its result, and exit without running any destructors.
+    [[noreturn]] void
+    run_child(test::work_unit const& u_, int fd_) noexcept {
+        std::string msg;
+        try {
+            m_ts.testsuite::run_units(std::vector<test::work_unit>{u_}, m_cfg,
+                                      [&](std::size_t, test::unit_result&& r_) {
+                                          std::vector<test::unit_result> res;
+                                          res.push_back(std::move(r_));
+                                          msg = net::result_message(res);
+                                      });
+        } catch (...) {
+            ::_exit(1);
+        }
+        for (std::size_t off{0}; off < msg.size();) {
+            auto const n{::write(fd_, msg.data() + off, msg.size() - off)};
+            if (n < 0 && errno != EINTR) {
+                ::_exit(1);
+            }
+            off += n > 0 ? static_cast<std::size_t>(n) : 0;
+        }
+        ::_exit(0);
+    }
+
+    /// Wait for output of any child, and finish those, that have exited, or timed out.
+    void
+    collect() {
+        std::vector<pollfd> fds;
+        auto                next{clock::time_point::max()};
+        for (auto const& c : m_children) {
+            fds.push_back(pollfd{c.fd, POLLIN, 0});
+            next = std::min(next, c.deadline);
+        }
+        auto const left{std::chrono::duration_cast<std::chrono::milliseconds>(next - clock::now()).count() + 1};
+        auto const wait{static_cast<int>(std::max<decltype(left)>(
+          0, std::min<decltype(left)>(left, std::numeric_limits<int>::max())))};
+        if (::poll(fds.data(), fds.size(), wait) < 0 && errno != EINTR) {
+            throw std::runtime_error(std::string("could not poll children: ") + std::strerror(errno));
+        }
+        char buf[65536];
+        for (std::size_t i{fds.size()}; i-- > 0;) {
+            if (fds[i].revents == 0) {
+                continue;
+            }
+            auto&      c{m_children[i]};
+            auto const n{::read(c.fd, buf, sizeof(buf))};
+            if (n > 0) {
+                c.data.append(buf, static_cast<std::size_t>(n));
+            } else if (n == 0 || errno != EINTR) {
+                finish(c);
+                m_children.erase(m_children.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+        }
+        auto const now{clock::now()};
+        for (std::size_t i{m_children.size()}; i-- > 0;) {
+            auto& c{m_children[i]};
+            if (now >= c.deadline) {
+                ::kill(c.pid, SIGKILL);
+                ::close(c.fd);
+                while (::waitpid(c.pid, nullptr, 0) < 0 && errno == EINTR) {
+                }
+                m_ts.lose(c.unit, "child process timed out, and was killed", m_cfg);
+                m_children.erase(m_children.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+        }
+    }
+
+    /// Merge the result of an exited child, or record an error for its unit, if it did not deliver one.
+    void
+    finish(child& c_) {
+        ::close(c_.fd);
+        int status{0};
+        while (::waitpid(c_.pid, &status, 0) < 0 && errno == EINTR) {
+        }
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+            try {
+                test::decoder d(c_.data);
+                net::expect_message(d, net::message::RESULT);
+                auto res{net::read_results(d, m_ts)};
+                if (res.size() == 1 && d.done()) {
+                    m_ts.merge(std::move(res.front()), m_cfg);
+                    return;
+                }
+            } catch (std::runtime_error const&) {
+            }
+        }
+        std::string reason;
+        if (WIFSIGNALED(status)) {
+            reason = "child process crashed by signal " + std::to_string(WTERMSIG(status)) + " (" +
+                     ::strsignal(WTERMSIG(status)) + ")";
+        } else if (WIFEXITED(status) && WEXITSTATUS(status) != 0) {
+            reason = "child process exited with status " + std::to_string(WEXITSTATUS(status));
+        } else {
+            reason = "child process sent no result";
+        }
+        m_ts.lose(c_.unit, reason.c_str(), m_cfg);
+    }
+
+    test::testsuite&        m_ts;
+    test::run_config const& m_cfg;
+    std::size_t const       m_jobs;
+    clock::duration const   m_timeout;
+    std::vector<child>      m_children;
+};
+#endif
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_ISOLATION_HPP
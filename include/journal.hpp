@@ -0,0 +1,253 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_JOURNAL_HPP
+#define TPP_JOURNAL_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "net/protocol.hpp"
+#include "test/codec.hpp"
+#include "test/run_config.hpp"
+#include "test/testsuite.hpp"
+#include "test/work_unit.hpp"
+
+#include "cpp_meta.hpp"
+
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+#    include <cerrno>
+#    include <fcntl.h>
+#    include <unistd.h>
+#endif
+
+namespace tpp
+{
+namespace intern
+{
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+/**
+ * An append-only journal of the results of finished units of work, which survives crashes of the test process.
+ * Records are written in batches, and each batch is synced to disk. A record, that was not written completely, is
+ * dropped when the journal is resumed. Hence at most the results of the last batch are lost.
+ *
+ * Each record is framed by its length, and the FNV-1a hash of its data. The first record identifies the binary.
+ * Every other record holds the index and name of a testsuite, and the result of one of its units of work.
+ */
+class journal
+{
+public:
+    /// Generators are split into units of this many cases, which is the same for every run.
+    static constexpr std::size_t CHUNK = 1024;
+
+    journal(journal const&)     = delete;
+    journal(journal&&) noexcept = delete;
+    auto
+    operator=(journal const&) -> journal& = delete;
+    auto
+    operator=(journal&&) noexcept -> journal& = delete;
+
+    /// Open the journal at path_. Unless it is resumed, any previous content is discarded.
+    journal(std::string const& path_, bool resume_)
+        : m_path(path_), m_fd(::open(path_.c_str(), O_RDWR | O_CREAT | O_APPEND | (resume_ ? 0 : O_TRUNC), 0644)) {
+        if (m_fd < 0) {
+            throw std::runtime_error("could not open journal " + path_);
+        }
+    }
+
+    ~journal() noexcept {
+        sync();
+        ::close(m_fd);
+    }
+
+    /**
+     * Merge all results from the journal into their testsuites, and remember which units of work are done.
+     * An incomplete, or corrupt tail is cut off, so that new records are appended to the last complete record.
+     */
+    void
+    replay(std::vector<test::testsuite_ptr> const& suites_, test::run_config const& cfg_) {
+        auto const  data{read_all()};
+        std::size_t pos{0};
+        std::string frame;
+        if (!next_frame(data, pos, frame)) {
+            truncate(0);
+            append(header());
+            flush();
+            return;
+        }
+        if (frame != header()) {
+            throw std::runtime_error("journal " + m_path + " was written by another binary");
+        }
+        auto valid{pos};
+        while (next_frame(data, pos, frame)) {
+            test::decoder d(frame);
+            auto const    suite{static_cast<std::size_t>(d.u64())};
+            if (suite >= suites_.size() || d.str() != suites_[suite]->name()) {
+                throw std::runtime_error("journal " + m_path + " does not match the testsuites of this binary");
+            }
+            net::expect_message(d, net::message::RESULT);
+            auto res{net::read_results(d, *suites_[suite])};
+            for (auto& r : res) {
+                m_done.insert(unit_key(suite, r.unit.item, r.unit.begin, r.unit.end));
+                suites_[suite]->merge(std::move(r), cfg_);
+            }
+            valid = pos;
+        }
+        truncate(valid);
+    }
+
+    /// Check whether a unit of work of a testsuite was replayed from the journal.
+    auto
+    done(std::size_t suite_, test::work_unit const& u_) const -> bool {
+        return m_done.count(unit_key(suite_, u_.item, u_.begin, u_.end)) > 0;
+    }
+
+    /// Record the result of a unit of work. Records are synced to disk in batches.
+    void
+    record(std::size_t suite_, test::testsuite const& ts_, test::unit_result const& res_) {
+        test::encoder e;
+        e.u64(suite_).str(ts_.name()).u8(static_cast<std::uint8_t>(net::message::RESULT)).u64(1);
+        net::write_result(e, res_);
+        append(e.data());
+        if (m_pending >= SYNC_RECORDS ||
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_last_sync)
+                    .count() >= SYNC_INTERVAL_MS) {
+            sync();
+        }
+    }
+
+    /// Sync all pending records to disk. Fails, if any record could not be written.
+    void
+    flush() {
+        if (!sync()) {
+            throw std::runtime_error("could not write journal " + m_path);
+        }
+    }
+
+private:
+    /// Unit of work of a testsuite as (suite, item, begin, end).
+    using unit_key = std::tuple<std::size_t, std::size_t, std::size_t, std::size_t>;
+
+    static constexpr std::size_t  FRAME_SIZE       = 16;  ///< Length, and hash of a record.
+    static constexpr std::size_t  SYNC_RECORDS     = 256;
+    static constexpr std::int64_t SYNC_INTERVAL_MS = 100;
+
+    static auto
+    header() -> std::string {
+        test::encoder e;
+        e.str("tpp-journal").u64(net::PROTOCOL_MAGIC).u64(net::binary_hash());
+        return e.data();
+    }
+
+    void
+    append(std::string const& rec_) {
+        test::encoder e;
+        e.u64(rec_.size()).u64(net::fnv1a(rec_.data(), rec_.size()));
+        m_buf += e.data();
+        m_buf += rec_;
+        ++m_pending;
+    }
+
+    /// Get the next complete, and intact record at pos_ in data_.
+    static auto
+    next_frame(std::string const& data_, std::size_t& pos_, std::string& frame_) -> bool {
+        if (data_.size() - pos_ < FRAME_SIZE) {
+            return false;
+        }
+        auto const    head{data_.substr(pos_, FRAME_SIZE)};
+        test::decoder d(head);
+        auto const    n{d.u64()};
+        auto const    hash{d.u64()};
+        if (data_.size() - pos_ - FRAME_SIZE < n) {
+            return false;
+        }
+        frame_ = data_.substr(pos_ + FRAME_SIZE, static_cast<std::size_t>(n));
+        if (net::fnv1a(frame_.data(), frame_.size()) != hash) {
+            return false;
+        }
+        pos_ += FRAME_SIZE + frame_.size();
+        return true;
+    }
+
+    auto
+    read_all() -> std::string {
+        std::string       data;
+        std::vector<char> buf(1U << 16U);
+        ::lseek(m_fd, 0, SEEK_SET);
+        for (;;) {
+            auto const n{::read(m_fd, buf.data(), buf.size())};
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                throw std::runtime_error("could not read journal " + m_path);
+            }
+            if (n == 0) {
+                return data;
+            }
+            data.append(buf.data(), static_cast<std::size_t>(n));
+        }
+    }
+
+    void
+    truncate(std::size_t size_) {
+        if (::ftruncate(m_fd, static_cast<off_t>(size_)) != 0) {
+            throw std::runtime_error("could not write journal " + m_path);
+        }
+    }
+
+    /// Write and sync all pending records. Once this failed, the journal stays failed.
+    auto
+    sync() noexcept -> bool {
+        std::size_t off{0};
+        while (!m_failed && off < m_buf.size()) {
+            auto const n{::write(m_fd, m_buf.data() + off, m_buf.size() - off)};
+            if (n < 0 && errno != EINTR) {
+                m_failed = true;
+            } else if (n > 0) {
+                off += static_cast<std::size_t>(n);
+            }
+        }
+        m_buf.erase(0, off);
+        if (!m_failed && m_pending > 0 && ::fdatasync(m_fd) != 0) {
+            m_failed = true;
+        }
+        m_pending   = 0;
+        m_last_sync = std::chrono::steady_clock::now();
+        return !m_failed;
+    }
+
+    std::string const                     m_path;
+    int const                             m_fd;
+    std::string                           m_buf;
+    std::size_t                           m_pending{0};  ///< Number of records, that are not synced yet.
+    std::chrono::steady_clock::time_point m_last_sync{std::chrono::steady_clock::now()};
+    bool                                  m_failed{false};
+    std::set<unit_key>                    m_done;
+};
+#endif
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_JOURNAL_HPP
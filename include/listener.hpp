@@ -0,0 +1,147 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_LISTENER_HPP
+#define TPP_LISTENER_HPP
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace tpp
+{
+namespace intern
+{
+namespace test
+{
+class testcase;
+class testsuite;
+}  // namespace test
+
+/**
+ * Listener of the results of a run, which is registered at the runner alongside its reporter. Results are passed as
+ * views, which are only valid during a call, so that nothing has to be serialized. All calls of the listeners of a
+ * runner are serialized, but on_test_end may be called from any thread, that ran a testcase. Other calls are made by
+ * the thread, that called runner::run. Listeners must not throw.
+ */
+class listener
+{
+public:
+    listener()                    = default;
+    listener(listener const&)     = delete;
+    listener(listener&&) noexcept = delete;
+    virtual ~listener() noexcept  = default;
+    auto
+    operator=(listener const&) -> listener& = delete;
+    auto
+    operator=(listener&&) noexcept -> listener& = delete;
+
+    /// Called once, before any testsuite is run.
+    virtual void
+    on_run_start() {}
+
+    /// Called before a testsuite is run.
+    virtual void
+    on_suite_start(test::testsuite const& ts_) {
+        static_cast<void>(ts_);
+    }
+
+    /**
+     * Called for each testcase, as soon as it finished. A testcase with sections is passed once, after all its sections
+     * were run, and they are its records. Each generated case is passed on its own, regardless of the report policy.
+     */
+    virtual void
+    on_test_end(test::testsuite const& ts_, test::testcase const& tc_) {
+        static_cast<void>(ts_);
+        static_cast<void>(tc_);
+    }
+
+    /// Called after a testsuite was run, when its statistics are complete.
+    virtual void
+    on_suite_end(test::testsuite const& ts_) {
+        static_cast<void>(ts_);
+    }
+
+    /// Called once, after all testsuites were run and reported.
+    virtual void
+    on_run_end() {}
+};
+
+using listener_ptr = std::shared_ptr<listener>;
+
+/// All listeners of a runner, whose calls are serialized.
+class listener_list final
+{
+public:
+    void
+    add(listener_ptr const& l_) {
+        m_listeners.push_back(l_);
+    }
+
+    inline auto
+    empty() const -> bool {
+        return m_listeners.empty();
+    }
+
+    void
+    run_start() {
+        notify([](listener& l_) { l_.on_run_start(); });
+    }
+
+    void
+    suite_start(test::testsuite const& ts_) {
+        notify([&](listener& l_) { l_.on_suite_start(ts_); });
+    }
+
+    void
+    test_end(test::testsuite const& ts_, test::testcase const& tc_) {
+        notify([&](listener& l_) { l_.on_test_end(ts_, tc_); });
+    }
+
+    void
+    suite_end(test::testsuite const& ts_) {
+        notify([&](listener& l_) { l_.on_suite_end(ts_); });
+    }
+
+    void
+    run_end() {
+        notify([](listener& l_) { l_.on_run_end(); });
+    }
+
+private:
+    template<typename Fn>
+    void
+    notify(Fn&& fn_) {
+        if (!m_listeners.empty()) {
+            std::lock_guard<std::mutex> const lk(m_mutex);
+            std::for_each(m_listeners.begin(), m_listeners.end(), [&](listener_ptr const& l_) { fn_(*l_); });
+        }
+    }
+
+    std::vector<listener_ptr> m_listeners;
+    std::mutex                m_mutex;
+};
+}  // namespace intern
+
+using listener     = intern::listener;
+using listener_ptr = intern::listener_ptr;
+using suite_result = intern::test::testsuite;
+using test_result  = intern::test::testcase;
+}  // namespace tpp
+
+#endif  // TPP_LISTENER_HPP
@@ -0,0 +1,231 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_META_RUNNER_HPP
+#define TPP_META_RUNNER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "net/coordinator.hpp"
+#include "net/protocol.hpp"
+
+#include "cmdline_parser.hpp"
+#include "config.hpp"
+#include "cpp_meta.hpp"
+#include "version.hpp"
+
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+#    include <fcntl.h>
+#    include <sys/types.h>
+#    include <sys/wait.h>
+#    include <unistd.h>
+#endif
+
+namespace tpp
+{
+namespace intern
+{
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+/**
+ * The meta-runner runs the testcases of many test binaries within one global budget of jobs.
+ * Each binary is started as single threaded workers of a coordinator, where workers are started on demand and
+ * quit when their binary runs out of work. So each job is one worker process running one testcase at a time.
+ * All results are merged into one report, where testsuites are prefixed with the name of their binary.
+ */
+class meta_runner
+{
+public:
+    meta_runner(std::vector<std::string> const& binaries_, std::size_t jobs_)
+        : m_binaries(binaries_), m_jobs(std::max<std::size_t>(1, jobs_)) {}
+
+    auto
+    run(config const& cfg_) noexcept -> int {
+        try {
+            net::coordinator coord("", 0);
+            coord.release_idle();
+            std::vector<std::size_t> ids;
+            std::for_each(m_binaries.begin(), m_binaries.end(), [&](std::string const& bin_) {
+                ids.push_back(coord.expect(net::file_hash(bin_), basename(bin_) + "/",
+                                           [&cfg_](char const* name_) { return cfg_.selects(name_); }));
+            });
+            m_live.assign(m_binaries.size(), 0);
+            m_failures.assign(m_binaries.size(), 0);
+            while (!coord.done()) {
+                reap(coord, false);
+                spawn(coord);
+                coord.poll(cfg_.run_cfg, POLL_INTERVAL_MS);
+            }
+            coord.finish(cfg_.run_cfg);
+            reap(coord, true);
+            auto rep{cfg_.reporter()};
+            rep->begin_report();
+            std::for_each(ids.begin(), ids.end(), [&](std::size_t id_) {
+                auto const suites{coord.suites(id_)};
+                std::for_each(suites.begin(), suites.end(), [&](test::testsuite_ptr const& ts_) { rep->report(ts_); });
+            });
+            rep->end_report();
+            return static_cast<int>(std::min(rep->faults(), static_cast<std::size_t>(std::numeric_limits<int>::max())));
+        } catch (std::runtime_error const& e) {
+            std::cerr << "A fatal error occurred!\n  what(): " << e.what() << std::endl;
+            return -2;
+        }
+    }
+
+    /**
+     * Parse the commandline, and run. The commandline is [-j <jobs>] [OPTIONS] -- <binary>...
+     * OPTIONS are the same as for a test binary, except for distribution.
+     */
+    static auto
+    main(int argc_, char const** argv_) noexcept -> int {
+        std::vector<char const*> args;
+        std::vector<std::string> binaries;
+        std::size_t              jobs{std::max(1U, std::thread::hardware_concurrency())};
+        try {
+            for (int i{0}; i < argc_; ++i) {
+                std::string const arg(argv_[i]);
+                if (arg == "--") {
+                    binaries.assign(argv_ + i + 1, argv_ + argc_);
+                    break;
+                }
+                if (arg == "--help") {
+                    print_help(argv_[0]);
+                    return 0;
+                }
+                if (arg == "-j" && i + 1 < argc_) {
+                    jobs = static_cast<std::size_t>(std::stoul(argv_[++i]));
+                } else {
+                    args.push_back(argv_[i]);
+                }
+            }
+            if (binaries.empty()) {
+                print_help(argc_ > 0 ? argv_[0] : "tpp-run");
+                return -1;
+            }
+            cmdline_parser cmd;
+            cmd.parse(args.size(), args.data());
+            if (cmd.config().dist != config::dist_mode::LOCAL) {
+                throw std::runtime_error("distribution options are not supported by the meta-runner!");
+            }
+            return meta_runner(binaries, jobs).run(cmd.config());
+        } catch (cmdline_parser::help_called) {
+            return -1;
+        } catch (std::exception const& e) {
+            std::cerr << "A fatal error occurred!\n  what(): " << e.what() << std::endl;
+            return -2;
+        }
+    }
+
+private:
+    static constexpr int         POLL_INTERVAL_MS = 50;
+    static constexpr std::size_t MAX_START_FAILURES = 3;
+
+    static void
+    print_help(char const* progname_) {
+        std::cout << "Meta-runner for unit testing binaries built with Test++ (" TPP_VERSION ").\n\n"
+                  << "Usage: " << progname_ << " [-j <jobs>] [OPTIONS] [filename] -- <binary>...\n"
+                  << "Runs the testcases of all binaries within a budget of jobs, and reports them together.\n"
+                     "Testsuites are prefixed with the name of their binary.\n\n"
+                     "  -j <jobs> : Number of testcases to run at once (default: number of CPUs).\n"
+                     "  OPTIONS are the same as for the test binaries, see their --help."
+                  << std::endl;
+    }
+
+    static auto
+    basename(std::string const& path_) -> std::string {
+        auto const pos{path_.rfind('/')};
+        return pos == std::string::npos ? path_ : path_.substr(pos + 1);
+    }
+
+    /// Start workers, while there are jobs left and some binary needs one.
+    void
+    spawn(net::coordinator const& coord_) {
+        for (std::size_t n{0}; m_procs.size() < m_jobs && n < m_binaries.size(); ++n) {
+            auto const b{m_next};
+            m_next = (m_next + 1) % m_binaries.size();
+            auto const idle{m_live[b] - std::min(m_live[b], coord_.busy(b))};
+            if ((!coord_.cataloged(b) && m_live[b] == 0) || (coord_.cataloged(b) && coord_.demand(b) > idle)) {
+                start(b, coord_.port());
+                n = 0;
+            }
+        }
+    }
+
+    void
+    start(std::size_t bin_, std::uint16_t port_) {
+        auto const& path{m_binaries[bin_]};
+        auto const  addr{"127.0.0.1:" + std::to_string(port_)};
+        auto const  pid{::fork()};
+        if (pid < 0) {
+            throw std::runtime_error("could not start " + path);
+        }
+        if (pid == 0) {
+            ::setenv("OMP_NUM_THREADS", "1", 1);
+            auto const null{::open("/dev/null", O_WRONLY)};
+            if (null >= 0) {
+                ::dup2(null, STDOUT_FILENO);
+            }
+            ::execl(path.c_str(), path.c_str(), "--worker", addr.c_str(), static_cast<char*>(nullptr));
+            ::_exit(127);
+        }
+        m_procs[pid] = bin_;
+        ++m_live[bin_];
+    }
+
+    /// Collect exited workers. A binary, that fails to start repeatedly, is an error.
+    void
+    reap(net::coordinator const& coord_, bool wait_) {
+        while (!m_procs.empty()) {
+            int        status{0};
+            auto const pid{::waitpid(-1, &status, wait_ ? 0 : WNOHANG)};
+            if (pid <= 0) {
+                return;
+            }
+            auto const it{m_procs.find(pid)};
+            if (it == m_procs.end()) {
+                continue;
+            }
+            auto const b{it->second};
+            m_procs.erase(it);
+            --m_live[b];
+            if (!coord_.cataloged(b) && m_live[b] == 0 && ++m_failures[b] >= MAX_START_FAILURES) {
+                throw std::runtime_error("could not run " + m_binaries[b] + " as worker");
+            }
+        }
+    }
+
+    std::vector<std::string>     m_binaries;
+    std::size_t const            m_jobs;
+    std::map<pid_t, std::size_t> m_procs;
+    std::vector<std::size_t>     m_live;
+    std::vector<std::size_t>     m_failures;
+    std::size_t                  m_next{0};
+};
+#endif
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_META_RUNNER_HPP
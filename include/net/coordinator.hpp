@@ -0,0 +1,517 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_NET_COORDINATOR_HPP
+#define TPP_NET_COORDINATOR_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "net/protocol.hpp"
+#include "net/tcp_socket.hpp"
+#include "test/run_config.hpp"
+#include "test/testsuite.hpp"
+
+#include "cpp_meta.hpp"
+
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+#    include <poll.h>
+#endif
+
+namespace tpp
+{
+namespace intern
+{
+namespace net
+{
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+/**
+ * The coordinator hands out units of work to any number of workers, and merges their results into testsuites.
+ * Workers are grouped by the hash of their binary. The testsuites of a binary are either given, or built from the
+ * catalog of its first worker.
+ * Units of a parallel testsuite are assigned in batches up to the capacity of a worker, while all units of a
+ * sequential testsuite are assigned together, in order.
+ * Units of a worker that dies, or does not answer in time, are reassigned, until a unit was lost too often and is
+ * reported as error. Messages are buffered per worker, so that a stalled worker does not block the others.
+ */
+class coordinator
+{
+public:
+    using select_function = std::function<bool(char const*)>;
+    using clock           = std::chrono::steady_clock;
+
+    /**
+     * Listen for workers on host_ at port_. If port_ is 0, any free port is chosen.
+     * If host_ is empty, only workers on this machine can connect.
+     */
+    coordinator(std::string const& host_, std::uint16_t port_, std::size_t chunk_ = 1024, std::size_t max_losses_ = 3)
+        : m_listener(tcp_socket::listen(host_, port_)), m_chunk(chunk_ > 0 ? chunk_ : 1), m_max_losses(max_losses_) {}
+
+    inline auto
+    port() const -> std::uint16_t {
+        return m_listener.port();
+    }
+
+    /**
+     * Distribute all pending testcases of the selected testsuites of this binary, and wait until all results are
+     * merged. Testsuites are identified by their index in suites_, which is the same for all workers.
+     */
+    void
+    run(std::vector<test::testsuite_ptr> const& suites_, std::vector<std::size_t> const& selected_,
+        test::run_config const& cfg_) {
+        add(binary_hash(), suites_, selected_);
+        while (!done()) {
+            poll(cfg_, -1);
+        }
+        finish(cfg_);
+    }
+
+    /// Add a binary, whose testsuites are known. Returns its id.
+    auto
+    add(std::uint64_t hash_, std::vector<test::testsuite_ptr> const& suites_, std::vector<std::size_t> const& selected_)
+      -> std::size_t {
+        m_binaries.emplace_back(hash_);
+        m_binaries.back().suites = suites_;
+        enqueue(m_binaries.back(), selected_);
+        return m_binaries.size() - 1;
+    }
+
+    /**
+     * Expect a binary, whose testsuites are built from the catalog of its first worker. Returns its id.
+     * @param prefix_ is prepended to the names of its testsuites.
+     * @param select_ decides by name, which testsuites are run.
+     */
+    auto
+    expect(std::uint64_t hash_, std::string const& prefix_, select_function&& select_) -> std::size_t {
+        m_binaries.emplace_back(hash_);
+        m_binaries.back().prefix    = prefix_;
+        m_binaries.back().select    = std::move(select_);
+        m_binaries.back().cataloged = false;
+        return m_binaries.size() - 1;
+    }
+
+    /// Tell idle workers to quit, if there is no more work for their binary.
+    inline void
+    release_idle() {
+        m_release = true;
+    }
+
+    /// Treat a worker as lost, if it does not answer to its work, or a request for the catalog, within timeout_.
+    inline void
+    timeout(clock::duration timeout_) {
+        m_timeout = timeout_;
+    }
+
+    /// Process events of workers, waiting at most timeout_ms milliseconds, or infinitely if it is negative.
+    void
+    poll(test::run_config const& cfg_, int timeout_ms_) {
+        std::vector<pollfd> fds;
+        fds.push_back(pollfd{m_listener.fd(), POLLIN, 0});
+        std::for_each(m_peers.begin(), m_peers.end(),
+                      [&](peer const& p_) { fds.push_back(pollfd{p_.sock.fd(), POLLIN, 0}); });
+        if (::poll(fds.data(), fds.size(), wait_ms(timeout_ms_)) < 0) {
+            if (errno == EINTR) {
+                return;
+            }
+            throw std::runtime_error(std::string("poll failed: ") + std::strerror(errno));
+        }
+        auto it{m_peers.begin()};
+        for (std::size_t i{1}; i < fds.size(); ++i, ++it) {
+            if (fds[i].revents != 0 && !receive(*it, cfg_)) {
+                lose(*it, "worker lost while running this testcase", cfg_);
+                it->sock.close();
+            }
+        }
+        auto const now{clock::now()};
+        std::for_each(m_peers.begin(), m_peers.end(), [&](peer& p_) {
+            if (p_.sock && p_.waiting() && now >= p_.deadline) {
+                lose(p_, "worker timed out while running this testcase", cfg_);
+                p_.sock.close();
+            }
+        });
+        if (fds[0].revents != 0) {
+            auto s{m_listener.accept()};
+            if (s) {
+                m_peers.emplace_back(std::move(s));
+            }
+        }
+        std::for_each(m_peers.begin(), m_peers.end(), [&](peer& p_) {
+            if (p_.sock && p_.state == peer::WELCOMED && p_.assigned.empty()) {
+                auto& bin{m_binaries[p_.bin]};
+                if (!bin.cataloged && !bin.listing) {
+                    if (!list(p_, bin)) {
+                        p_.sock.close();
+                    }
+                } else if (!bin.queue.empty()) {
+                    if (!assign(p_)) {
+                        p_.sock.close();
+                    }
+                } else if (m_release && bin.cataloged) {
+                    p_.sock.send(make_message(message::DONE).data());
+                    p_.sock.close();
+                }
+            }
+        });
+        m_peers.remove_if([](peer const& p_) { return !p_.sock; });
+    }
+
+    /// Check whether all binaries are known, and all units of work have a result.
+    auto
+    done() const -> bool {
+        return m_open == 0 && std::all_of(m_binaries.begin(), m_binaries.end(),
+                                          [](binary const& b_) { return b_.cataloged; });
+    }
+
+    /// Tell all workers that they are done, and complete all testsuites.
+    void
+    finish(test::run_config const& cfg_) {
+        std::for_each(m_peers.begin(), m_peers.end(),
+                      [](peer const& p_) { p_.sock.send(make_message(message::DONE).data()); });
+        m_peers.clear();
+        std::for_each(m_binaries.begin(), m_binaries.end(), [&](binary& b_) {
+            std::for_each(b_.selected.begin(), b_.selected.end(),
+                          [&](std::size_t s_) { b_.suites[s_]->complete(cfg_); });
+        });
+    }
+
+    /// Get the number of batches of work, that are queued for a binary.
+    inline auto
+    demand(std::size_t bin_) const -> std::size_t {
+        return m_binaries.at(bin_).queue.size();
+    }
+
+    /// Get the number of workers of a binary, that are connected.
+    auto
+    workers(std::size_t bin_) const -> std::size_t {
+        return static_cast<std::size_t>(
+          std::count_if(m_peers.begin(), m_peers.end(), [&](peer const& p_) { return p_.bin == bin_; }));
+    }
+
+    /// Get the number of workers of a binary, that are busy.
+    auto
+    busy(std::size_t bin_) const -> std::size_t {
+        return static_cast<std::size_t>(std::count_if(m_peers.begin(), m_peers.end(), [&](peer const& p_) {
+            return p_.bin == bin_ && !p_.assigned.empty();
+        }));
+    }
+
+    inline auto
+    cataloged(std::size_t bin_) const -> bool {
+        return m_binaries.at(bin_).cataloged;
+    }
+
+    /// Get the selected testsuites of a binary.
+    auto
+    suites(std::size_t bin_) const -> std::vector<test::testsuite_ptr> {
+        auto const&                      b{m_binaries.at(bin_)};
+        std::vector<test::testsuite_ptr> res;
+        std::for_each(b.selected.begin(), b.selected.end(), [&](std::size_t s_) { res.push_back(b.suites[s_]); });
+        return res;
+    }
+
+private:
+    struct pending_unit
+    {
+        std::size_t     suite;
+        test::work_unit unit;
+        std::size_t     losses;
+    };
+
+    using batch = std::vector<pending_unit>;
+
+    struct binary
+    {
+        explicit binary(std::uint64_t hash_) : hash(hash_) {}
+
+        std::uint64_t                    hash;
+        std::vector<test::testsuite_ptr> suites;
+        std::vector<std::size_t>         selected;
+        std::deque<batch>                queue;
+        std::string                      prefix;
+        std::deque<std::string>          names;  ///< Owns the names of testsuites, that were built from a catalog.
+        select_function                  select;
+        bool                             cataloged{true};
+        bool                             listing{false};  ///< Whether a worker was asked for the catalog.
+    };
+
+    struct peer
+    {
+        explicit peer(tcp_socket&& s_) : sock(std::move(s_)) {}
+
+        enum states
+        {
+            HELLO,
+            LISTING,
+            WELCOMED
+        };
+
+        /// Check whether an answer of the peer is awaited.
+        inline auto
+        waiting() const -> bool {
+            return state == LISTING || !assigned.empty();
+        }
+
+        tcp_socket        sock;
+        states            state{HELLO};
+        std::size_t       bin{0};
+        std::size_t       capacity{1};
+        batch             assigned;
+        std::string       inbox;  ///< Received data, that is not yet a complete message.
+        clock::time_point deadline;
+    };
+
+    /// Queue all units of the selected testsuites. A sequential testsuite is one batch, else each unit is.
+    void
+    enqueue(binary& bin_, std::vector<std::size_t> const& selected_) {
+        bin_.selected = selected_;
+        std::for_each(selected_.begin(), selected_.end(), [&](std::size_t s_) {
+            auto const& ts{*bin_.suites.at(s_)};
+            auto const  units{ts.units(m_chunk)};
+            m_open += units.size();
+            std::for_each(units.begin(), units.end(), [&](test::work_unit const& u_) {
+                if (!ts.parallel() && !bin_.queue.empty() && bin_.queue.back().front().suite == s_) {
+                    bin_.queue.back().push_back(pending_unit{s_, u_, 0});
+                } else {
+                    bin_.queue.push_back(batch{pending_unit{s_, u_, 0}});
+                }
+            });
+        });
+    }
+
+    /// Get how long to wait in poll, so that no deadline of a peer is missed.
+    auto
+    wait_ms(int timeout_ms_) const -> int {
+        auto const now{clock::now()};
+        auto       res{timeout_ms_};
+        std::for_each(m_peers.begin(), m_peers.end(), [&](peer const& p_) {
+            if (p_.waiting()) {
+                auto const left{p_.deadline > now ?
+                                  std::chrono::duration_cast<std::chrono::milliseconds>(p_.deadline - now).count() + 1 :
+                                  0};
+                auto const ms{static_cast<int>(std::min<decltype(left)>(left, std::numeric_limits<int>::max()))};
+                res = res < 0 ? ms : std::min(res, ms);
+            }
+        });
+        return res;
+    }
+
+    /// Receive the messages of a peer, that are available, and handle them. Returns false, if the peer is lost.
+    auto
+    receive(peer& p_, test::run_config const& cfg_) -> bool {
+        if (!p_.sock.recv_some(p_.inbox)) {
+            return false;
+        }
+        try {
+            std::string msg;
+            while (p_.sock && tcp_socket::take(p_.inbox, msg)) {
+                if (!handle(p_, msg, cfg_)) {
+                    return false;
+                }
+            }
+            return true;
+        } catch (std::runtime_error const&) {
+            return false;
+        }
+    }
+
+    /// Handle a message of a peer. Returns false, if the peer is lost.
+    auto
+    handle(peer& p_, std::string const& msg_, test::run_config const& cfg_) -> bool {
+        try {
+            test::decoder d(msg_);
+            switch (p_.state) {
+                case peer::HELLO: return handle_hello(p_, d, cfg_);
+                case peer::LISTING: {
+                    auto& bin{m_binaries[p_.bin]};
+                    expect_message(d, message::CATALOG);
+                    bin.suites = read_catalog(d, bin.prefix, bin.names);
+                    std::vector<std::size_t> sel;
+                    for (std::size_t i{0}; i < bin.suites.size(); ++i) {
+                        if (bin.select(bin.suites[i]->name())) {
+                            sel.push_back(i);
+                        }
+                    }
+                    enqueue(bin, sel);
+                    bin.cataloged = true;
+                    return welcome(p_, cfg_);
+                }
+                default: return handle_result(p_, d, cfg_);
+            }
+        } catch (std::runtime_error const&) {
+            return false;
+        }
+    }
+
+    auto
+    handle_hello(peer& p_, test::decoder& d_, test::run_config const& cfg_) -> bool {
+        expect_message(d_, message::HELLO);
+        auto const magic{d_.u64()};
+        auto const hash{d_.u64()};
+        auto const bin{std::find_if(m_binaries.begin(), m_binaries.end(),
+                                    [&](binary const& b_) { return b_.hash == hash; })};
+        if (magic != PROTOCOL_MAGIC || bin == m_binaries.end()) {
+            p_.sock.send(make_message(message::REJECT).str("binary hash mismatch").data());
+            return false;
+        }
+        p_.bin      = static_cast<std::size_t>(bin - m_binaries.begin());
+        p_.capacity = std::max<std::size_t>(1, static_cast<std::size_t>(d_.u64()));
+        if (!bin->cataloged && !bin->listing) {
+            return list(p_, *bin);
+        }
+        return welcome(p_, cfg_);
+    }
+
+    /// Ask a peer for the catalog of its binary. Returns false, if the peer is lost.
+    auto
+    list(peer& p_, binary& bin_) -> bool {
+        bin_.listing = true;
+        p_.state     = peer::LISTING;
+        p_.deadline  = clock::now() + m_timeout;
+        return p_.sock.send(make_message(message::LIST).data());
+    }
+
+    auto
+    welcome(peer& p_, test::run_config const& cfg_) -> bool {
+        p_.state = peer::WELCOMED;
+        auto msg{make_message(message::WELCOME)};
+        msg.u8(static_cast<std::uint8_t>(cfg_.gen_policy));
+        return p_.sock.send(msg.data());
+    }
+
+    auto
+    handle_result(peer& p_, test::decoder& d_, test::run_config const& cfg_) -> bool {
+        expect_message(d_, message::RESULT);
+        if (p_.assigned.empty()) {
+            return false;
+        }
+        auto const& ts{*m_binaries[p_.bin].suites[p_.assigned.front().suite]};
+        auto        res{read_results(d_, ts)};
+        if (res.size() != p_.assigned.size()) {
+            return false;
+        }
+        for (std::size_t i{0}; i < res.size(); ++i) {
+            auto const& u{p_.assigned[i].unit};
+            if (res[i].unit.item != u.item || res[i].unit.begin != u.begin || res[i].unit.end != u.end ||
+                (u.begin == u.end && res[i].records.size() != 1)) {
+                return false;
+            }
+        }
+        auto const& suites{m_binaries[p_.bin].suites};
+        for (std::size_t i{0}; i < res.size(); ++i) {
+            suites[p_.assigned[i].suite]->merge(std::move(res[i]), cfg_);
+        }
+        m_open -= p_.assigned.size();
+        p_.assigned.clear();
+        return true;
+    }
+
+    /// Assign the next batch of work to a peer. Returns false, if the peer is lost.
+    auto
+    assign(peer& p_) -> bool {
+        auto& bin{m_binaries[p_.bin]};
+        auto  suite{bin.queue.front().front().suite};
+        p_.assigned = std::move(bin.queue.front());
+        bin.queue.pop_front();
+        if (bin.suites[suite]->parallel()) {
+            while (p_.assigned.size() < p_.capacity && !bin.queue.empty() && batchable(p_.assigned.back()) &&
+                   batchable(bin.queue.front().front()) && bin.queue.front().front().suite == suite) {
+                p_.assigned.push_back(bin.queue.front().front());
+                bin.queue.pop_front();
+            }
+        }
+        std::vector<test::work_unit> units;
+        std::for_each(p_.assigned.begin(), p_.assigned.end(),
+                      [&](pending_unit const& u_) { units.push_back(u_.unit); });
+        p_.deadline = clock::now() + m_timeout;
+        if (!p_.sock.send(work_message(suite, units))) {
+            requeue(p_, false);
+            return false;
+        }
+        return true;
+    }
+
+    /// Generator chunks, and units that were lost before, are assigned alone.
+    static inline auto
+    batchable(pending_unit const& u_) -> bool {
+        return u_.losses == 0 && u_.unit.begin == u_.unit.end;
+    }
+
+    /// Requeue the work of a lost peer. Units that were lost too often are recorded as erroneous, because of reason_.
+    void
+    lose(peer& p_, char const* reason_, test::run_config const& cfg_) {
+        if (p_.state == peer::HELLO) {
+            return;
+        }
+        auto& bin{m_binaries[p_.bin]};
+        if (p_.state == peer::LISTING) {
+            bin.listing = false;
+        }
+        std::for_each(p_.assigned.begin(), p_.assigned.end(), [&](pending_unit& u_) {
+            if (++u_.losses >= m_max_losses) {
+                bin.suites[u_.suite]->lose(u_.unit, reason_, cfg_);
+                --m_open;
+            }
+        });
+        p_.assigned.erase(std::remove_if(p_.assigned.begin(), p_.assigned.end(),
+                                         [&](pending_unit const& u_) { return u_.losses >= m_max_losses; }),
+                          p_.assigned.end());
+        requeue(p_, true);
+    }
+
+    /// Requeue the work of a peer. If split_ is set, units of a parallel testsuite are requeued one by one.
+    void
+    requeue(peer& p_, bool split_) {
+        if (p_.assigned.empty()) {
+            return;
+        }
+        auto& bin{m_binaries[p_.bin]};
+        if (split_ && bin.suites[p_.assigned.front().suite]->parallel()) {
+            for (auto it{p_.assigned.rbegin()}; it != p_.assigned.rend(); ++it) {
+                bin.queue.push_front(batch{*it});
+            }
+        } else {
+            bin.queue.push_front(std::move(p_.assigned));
+        }
+        p_.assigned.clear();
+    }
+
+    tcp_socket         m_listener;
+    std::size_t const  m_chunk;
+    std::size_t const  m_max_losses;
+    bool               m_release{false};
+    clock::duration    m_timeout{std::chrono::minutes(10)};
+    std::deque<binary> m_binaries;
+    std::list<peer>    m_peers;
+    std::size_t        m_open{0};  ///< Number of units without result.
+};
+#endif
+}  // namespace net
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_NET_COORDINATOR_HPP
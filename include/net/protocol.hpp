@@ -0,0 +1,228 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_NET_PROTOCOL_HPP
+#define TPP_NET_PROTOCOL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "test/codec.hpp"
+#include "test/run_config.hpp"
+#include "test/testsuite.hpp"
+#include "test/testsuite_parallel.hpp"
+#include "test/work_unit.hpp"
+
+#include "fatal.hpp"
+
+namespace tpp
+{
+namespace intern
+{
+namespace net
+{
+/**
+ * Messages exchanged between coordinator and workers.
+ * A worker says HELLO, and is either rejected, or welcomed. Before it is welcomed, it may be asked to LIST its
+ * testsuites, and answers with a CATALOG. Afterwards it gets WORK, and answers with a RESULT, until it is told that
+ * all work is DONE.
+ */
+enum class message : std::uint8_t
+{
+    HELLO = 1,
+    WELCOME,
+    REJECT,
+    WORK,
+    RESULT,
+    DONE,
+    LIST,
+    CATALOG
+};
+
+/// Identifies the protocol, and its version.
+static constexpr std::uint64_t PROTOCOL_MAGIC = 0x0002505054ULL;
+
+/// Continue the FNV-1a hash h_ over n_ bytes of data.
+inline auto
+fnv1a(char const* data_, std::size_t n_, std::uint64_t h_ = 0xcbf29ce484222325ULL) -> std::uint64_t {
+    for (std::size_t i{0}; i < n_; ++i) {
+        h_ = (h_ ^ static_cast<unsigned char>(data_[i])) * 0x100000001b3ULL;
+    }
+    return h_;
+}
+
+/// Compute the FNV-1a hash of a file.
+inline auto
+file_hash(std::string const& path_) -> std::uint64_t {
+    std::ifstream in(path_, std::ios::binary);
+    if (!in) {
+        TPP_INTERN_THROW(std::runtime_error("could not read " + path_));
+    }
+    std::uint64_t     h{fnv1a(nullptr, 0)};
+    std::vector<char> buf(1U << 16U);
+    while (in.read(buf.data(), static_cast<std::streamsize>(buf.size())) || in.gcount() > 0) {
+        h = fnv1a(buf.data(), static_cast<std::size_t>(in.gcount()), h);
+    }
+    return h;
+}
+
+/// Get the hash of the executable of this process, so that only identical binaries work together.
+inline auto
+binary_hash() -> std::uint64_t {
+    static std::uint64_t const hash{file_hash("/proc/self/exe")};
+    return hash;
+}
+
+inline auto
+make_message(message type_) -> test::encoder {
+    test::encoder e;
+    e.u8(static_cast<std::uint8_t>(type_));
+    return e;
+}
+
+/// Read the type of a message, and fail if it is not the expected one.
+inline void
+expect_message(test::decoder& d_, message type_) {
+    if (d_.u8() != static_cast<std::uint8_t>(type_)) {
+        TPP_INTERN_THROW(std::runtime_error("unexpected message"));
+    }
+}
+
+inline auto
+hello_message(std::uint64_t hash_, std::uint64_t capacity_) -> std::string {
+    return make_message(message::HELLO).u64(PROTOCOL_MAGIC).u64(hash_).u64(capacity_).data();
+}
+
+inline auto
+work_message(std::size_t suite_, std::vector<test::work_unit> const& units_) -> std::string {
+    auto e{make_message(message::WORK)};
+    e.u64(suite_).u64(units_.size());
+    for (auto const& u : units_) {
+        e.u64(u.item).u64(u.begin).u64(u.end);
+    }
+    return e.data();
+}
+
+inline auto
+read_units(test::decoder& d_) -> std::vector<test::work_unit> {
+    std::vector<test::work_unit> units;
+    auto const                   n{d_.u64()};
+    for (std::uint64_t i{0}; i < n; ++i) {
+        auto const item{static_cast<std::size_t>(d_.u64())};
+        auto const begin{static_cast<std::size_t>(d_.u64())};
+        units.push_back(test::work_unit{item, begin, static_cast<std::size_t>(d_.u64())});
+    }
+    return units;
+}
+
+inline void
+write_result(test::encoder& e_, test::unit_result const& r_) {
+    e_.u64(r_.unit.item).u64(r_.unit.begin).u64(r_.unit.end).u64(r_.passed).f64(r_.passed_t).u64(r_.records.size());
+    for (auto const& rec : r_.records) {
+        e_.u64(rec.first).tc(rec.second);
+    }
+}
+
+inline auto
+result_message(std::vector<test::unit_result> const& res_) -> std::string {
+    auto e{make_message(message::RESULT)};
+    e.u64(res_.size());
+    for (auto const& r : res_) {
+        write_result(e, r);
+    }
+    return e.data();
+}
+
+/// Read the results of units of work, which belong to the testsuite ts_.
+inline auto
+read_results(test::decoder& d_, test::testsuite const& ts_) -> std::vector<test::unit_result> {
+    std::vector<test::unit_result> res;
+    auto const                     n{d_.u64()};
+    for (std::uint64_t i{0}; i < n; ++i) {
+        auto const item{static_cast<std::size_t>(d_.u64())};
+        auto const begin{static_cast<std::size_t>(d_.u64())};
+        auto const end{static_cast<std::size_t>(d_.u64())};
+        res.emplace_back(test::work_unit{item, begin, end});
+        auto& r{res.back()};
+        r.passed   = static_cast<std::size_t>(d_.u64());
+        r.passed_t = d_.f64();
+        auto const ctx{ts_.context(item)};
+        auto const m{d_.u64()};
+        for (std::uint64_t j{0}; j < m; ++j) {
+            auto const idx{static_cast<std::size_t>(d_.u64())};
+            r.records.emplace_back(idx, d_.tc(ctx));
+        }
+    }
+    return res;
+}
+
+/// Describe the testsuites of this binary, so that a coordinator can build them without testcase functions.
+inline auto
+catalog_message(std::vector<test::testsuite_ptr> const& suites_) -> std::string {
+    auto e{make_message(message::CATALOG)};
+    e.u64(suites_.size());
+    std::for_each(suites_.begin(), suites_.end(), [&](test::testsuite_ptr const& ts_) {
+        e.str(ts_->name()).u8(ts_->parallel() ? 1 : 0).u64(ts_->testcases().size());
+        std::for_each(ts_->testcases().begin(), ts_->testcases().end(),
+                      [&](test::testcase const& tc_) { e.str(tc_.name()); });
+        e.u64(ts_->generators().size());
+        std::for_each(ts_->generators().begin(), ts_->generators().end(),
+                      [&](test::generator const& gen_) { e.str(gen_.name()).u64(gen_.size()); });
+    });
+    return e.data();
+}
+
+/**
+ * Build testsuites from a catalog. Testsuite names are prefixed by prefix_.
+ * As testsuites do not own names, they are stored in names_, which must outlive the testsuites.
+ */
+inline auto
+read_catalog(test::decoder& d_, std::string const& prefix_, std::deque<std::string>& names_)
+  -> std::vector<test::testsuite_ptr> {
+    auto const name{[&](std::string&& s_) -> char const* {
+        names_.push_back(std::move(s_));
+        return names_.back().c_str();
+    }};
+    std::vector<test::testsuite_ptr> suites;
+    auto const                       n{d_.u64()};
+    for (std::uint64_t i{0}; i < n; ++i) {
+        auto const ts_name{name(prefix_ + d_.str())};
+        auto       ts{d_.u8() != 0 ? test::testsuite_parallel::create(ts_name) : test::testsuite::create(ts_name)};
+        auto const num_tc{d_.u64()};
+        for (std::uint64_t j{0}; j < num_tc; ++j) {
+            ts->test(name(d_.str()), nullptr);
+        }
+        auto const num_gen{d_.u64()};
+        for (std::uint64_t j{0}; j < num_gen; ++j) {
+            auto const gen_name{name(d_.str())};
+            ts->generate(gen_name, static_cast<std::size_t>(d_.u64()), nullptr);
+        }
+        suites.push_back(std::move(ts));
+    }
+    return suites;
+}
+}  // namespace net
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_NET_PROTOCOL_HPP
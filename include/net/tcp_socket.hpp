@@ -0,0 +1,311 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_NET_TCP_SOCKET_HPP
+#define TPP_NET_TCP_SOCKET_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "cpp_meta.hpp"
+
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+#    include <netdb.h>
+#    include <netinet/in.h>
+#    include <netinet/tcp.h>
+#    include <sys/socket.h>
+#    include <unistd.h>
+#endif
+
+namespace tpp
+{
+namespace intern
+{
+namespace net
+{
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+/**
+ * A blocking TCP socket, that exchanges length prefixed messages.
+ * Errors on setup throw a runtime_error, while a broken connection is reported by return value.
+ * Messages can also be received without blocking, by buffering them with recv_some and take.
+ */
+class tcp_socket
+{
+public:
+    tcp_socket(tcp_socket const&) = delete;
+    auto
+    operator=(tcp_socket const&) -> tcp_socket& = delete;
+
+    tcp_socket() = default;
+
+    explicit tcp_socket(int fd_) : m_fd(fd_) {}
+
+    tcp_socket(tcp_socket&& other_) noexcept : m_fd(other_.m_fd) {
+        other_.m_fd = -1;
+    }
+
+    auto
+    operator=(tcp_socket&& other_) noexcept -> tcp_socket& {
+        if (this != &other_) {
+            close();
+            m_fd        = other_.m_fd;
+            other_.m_fd = -1;
+        }
+        return *this;
+    }
+
+    ~tcp_socket() noexcept {
+        close();
+    }
+
+    /// Largest message, that is accepted. Peers are not authenticated, so larger frames are a protocol violation.
+    static constexpr std::size_t MAX_MESSAGE = 8U << 20U;
+
+    /**
+     * Listen on host_ at port_. If port_ is 0, any free port is chosen.
+     * If host_ is empty, only the loopback interface is listened on. A host of :: listens on all interfaces.
+     */
+    static auto
+    listen(std::string const& host_, std::uint16_t port_) -> tcp_socket {
+        addrinfo  hints{};
+        addrinfo* res{nullptr};
+        hints.ai_family   = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags    = AI_PASSIVE | AI_NUMERICSERV;
+        auto const host{host_.empty() ? std::string("127.0.0.1") : host_};
+        if (::getaddrinfo(host.c_str(), std::to_string(port_).c_str(), &hints, &res) != 0 || !res) {
+            throw std::runtime_error("could not resolve " + host);
+        }
+        int const  on{1};
+        int const  off{0};
+        tcp_socket s;
+        for (auto* ai{res}; ai && !s; ai = ai->ai_next) {
+            s = tcp_socket(::socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol));
+            if (s) {
+                ::setsockopt(s.m_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+                if (ai->ai_family == AF_INET6) {
+                    ::setsockopt(s.m_fd, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off));
+                }
+                if (::bind(s.m_fd, ai->ai_addr, ai->ai_addrlen) != 0 || ::listen(s.m_fd, SOMAXCONN) != 0) {
+                    s.close();
+                }
+            }
+        }
+        ::freeaddrinfo(res);
+        if (!s) {
+            throw_error("could not listen on " + host + ":" + std::to_string(port_));
+        }
+        return s;
+    }
+
+    /// Connect to host_ at port_.
+    static auto
+    connect(std::string const& host_, std::uint16_t port_) -> tcp_socket {
+        addrinfo  hints{};
+        addrinfo* res{nullptr};
+        hints.ai_family   = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        if (::getaddrinfo(host_.c_str(), std::to_string(port_).c_str(), &hints, &res) != 0 || !res) {
+            throw std::runtime_error("could not resolve " + host_);
+        }
+        tcp_socket s;
+        for (auto* ai{res}; ai && !s; ai = ai->ai_next) {
+            s = tcp_socket(::socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol));
+            if (s && ::connect(s.m_fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+                s.close();
+            }
+        }
+        ::freeaddrinfo(res);
+        if (!s) {
+            throw_error("could not connect to " + host_ + ":" + std::to_string(port_));
+        }
+        s.setup_stream();
+        return s;
+    }
+
+    /// Accept a pending connection.
+    auto
+    accept() const -> tcp_socket {
+        tcp_socket s(::accept4(m_fd, nullptr, nullptr, SOCK_CLOEXEC));
+        if (s) {
+            s.setup_stream();
+        }
+        return s;
+    }
+
+    /// Get the local port this socket is bound to.
+    auto
+    port() const -> std::uint16_t {
+        sockaddr_storage addr{};
+        socklen_t        len{sizeof(addr)};
+        if (::getsockname(m_fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            throw_error("could not get socket address");
+        }
+        return ntohs(addr.ss_family == AF_INET6 ? reinterpret_cast<sockaddr_in6*>(&addr)->sin6_port :
+                                                  reinterpret_cast<sockaddr_in*>(&addr)->sin_port);
+    }
+
+    /// Send a message. Returns false, if the connection is broken.
+    auto
+    send(std::string const& msg_) const -> bool {
+        if (msg_.size() > MAX_MESSAGE) {
+            throw std::runtime_error("message too large");
+        }
+        std::string frame;
+        frame.reserve(msg_.size() + 4);
+        for (auto i{0U}; i < 4U; ++i) {
+            frame.push_back(static_cast<char>((msg_.size() >> (i * 8U)) & 0xFFU));
+        }
+        frame.append(msg_);
+        return send_all(frame.data(), frame.size());
+    }
+
+    /// Receive a message. Returns false, if the connection is broken, or closed, or the message is too large.
+    auto
+    recv(std::string& msg_) const -> bool {
+        char hdr[4];
+        if (!recv_all(hdr, sizeof(hdr))) {
+            return false;
+        }
+        auto const len{frame_length(hdr)};
+        if (len > MAX_MESSAGE) {
+            return false;
+        }
+        msg_.resize(len);
+        return len == 0 || recv_all(&msg_[0], len);
+    }
+
+    /**
+     * Append the data, that is available, to buf_ without blocking.
+     * Returns false, if the connection is broken, or closed.
+     */
+    auto
+    recv_some(std::string& buf_) const -> bool {
+        char       chunk[65536];
+        auto const n{::recv(m_fd, chunk, sizeof(chunk), MSG_DONTWAIT)};
+        if (n < 0) {
+            return errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        buf_.append(chunk, static_cast<std::size_t>(n));
+        return n > 0;
+    }
+
+    /**
+     * Take the next complete message from buf_, that was filled by recv_some. Returns false, if it is incomplete.
+     * @throw std::runtime_error if the message is too large.
+     */
+    static auto
+    take(std::string& buf_, std::string& msg_) -> bool {
+        if (buf_.size() < 4) {
+            return false;
+        }
+        auto const len{frame_length(buf_.data())};
+        if (len > MAX_MESSAGE) {
+            throw std::runtime_error("message too large");
+        }
+        if (buf_.size() - 4 < len) {
+            return false;
+        }
+        msg_.assign(buf_, 4, len);
+        buf_.erase(0, len + 4);
+        return true;
+    }
+
+    void
+    close() noexcept {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+    }
+
+    inline auto
+    fd() const -> int {
+        return m_fd;
+    }
+
+    explicit operator bool() const noexcept {
+        return m_fd >= 0;
+    }
+
+private:
+    [[noreturn]] static void
+    throw_error(std::string const& msg_) {
+        throw std::runtime_error(msg_ + ": " + std::strerror(errno));
+    }
+
+    static auto
+    frame_length(char const* hdr_) -> std::size_t {
+        std::size_t len{0};
+        for (auto i{0U}; i < 4U; ++i) {
+            len |= static_cast<std::size_t>(static_cast<unsigned char>(hdr_[i])) << (i * 8U);
+        }
+        return len;
+    }
+
+    /// Disable nagling for the request-response pattern, and detect dead peers via keepalive.
+    void
+    setup_stream() const {
+        int const on{1};
+        ::setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        ::setsockopt(m_fd, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on));
+    }
+
+    auto
+    send_all(char const* buf_, std::size_t len_) const -> bool {
+        while (len_ > 0) {
+            auto const n{::send(m_fd, buf_, len_, MSG_NOSIGNAL)};
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            buf_ += n;
+            len_ -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    auto
+    recv_all(char* buf_, std::size_t len_) const -> bool {
+        while (len_ > 0) {
+            auto const n{::recv(m_fd, buf_, len_, 0)};
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            buf_ += n;
+            len_ -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    int m_fd{-1};
+};
+#endif
+}  // namespace net
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_NET_TCP_SOCKET_HPP
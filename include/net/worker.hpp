@@ -0,0 +1,133 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_NET_WORKER_HPP
+#define TPP_NET_WORKER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "net/protocol.hpp"
+#include "net/tcp_socket.hpp"
+#include "test/run_config.hpp"
+#include "test/testsuite.hpp"
+
+#include "cpp_meta.hpp"
+
+namespace tpp
+{
+namespace intern
+{
+namespace net
+{
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+/// A worker runs units of work, that are assigned by a coordinator, and sends back their results.
+class worker
+{
+public:
+    /// Connect to the coordinator at host_:port_. The coordinator may start up to some seconds later.
+    worker(std::string const& host_, std::uint16_t port_) {
+        for (auto i{0U};; ++i) {
+            try {
+                m_sock = tcp_socket::connect(host_, port_);
+                break;
+            } catch (std::runtime_error const&) {
+                if (i >= CONNECT_RETRIES) {
+                    throw;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        }
+    }
+
+    /**
+     * Run assigned units of work, until the coordinator is done.
+     * Testsuites are identified by their index in suites_, which must be the same as for the coordinator.
+     * @param capacity_ is the number of units that are run at once in parallel testsuites.
+     */
+    void
+    run(std::vector<test::testsuite_ptr> const& suites_, std::size_t capacity_) {
+        std::set<std::size_t> used;
+        try {
+            test::run_config cfg;
+            if (!m_sock.send(hello_message(binary_hash(), capacity_))) {
+                throw std::runtime_error("lost connection to coordinator");
+            }
+            for (;;) {
+                std::string msg;
+                if (!m_sock.recv(msg)) {
+                    throw std::runtime_error("lost connection to coordinator");
+                }
+                test::decoder d(msg);
+                switch (static_cast<message>(d.u8())) {
+                    case message::WELCOME: cfg.gen_policy = static_cast<test::generator_policy>(d.u8()); break;
+                    case message::LIST:
+                        if (!m_sock.send(catalog_message(suites_))) {
+                            throw std::runtime_error("lost connection to coordinator");
+                        }
+                        break;
+                    case message::REJECT: throw std::runtime_error("rejected by coordinator: " + d.str());
+                    case message::WORK: {
+                        auto const                     suite{static_cast<std::size_t>(d.u64())};
+                        auto const                     units{read_units(d)};
+                        auto const&                    ts{suites_.at(suite)};
+                        std::vector<test::unit_result> res(units.size());
+                        used.insert(suite);
+                        ts->run_units(units, cfg,
+                                      [&](std::size_t i_, test::unit_result&& r_) { res[i_] = std::move(r_); });
+                        if (!m_sock.send(result_message(res))) {
+                            throw std::runtime_error("lost connection to coordinator");
+                        }
+                        break;
+                    }
+                    case message::DONE: finish(suites_, used); return;
+                    default: throw std::runtime_error("unexpected message");
+                }
+            }
+        } catch (std::out_of_range const&) {
+            finish(suites_, used);
+            throw std::runtime_error("coordinator assigned an unknown testsuite");
+        } catch (...) {
+            finish(suites_, used);
+            throw;
+        }
+    }
+
+private:
+    static constexpr unsigned CONNECT_RETRIES = 100;
+
+    static void
+    finish(std::vector<test::testsuite_ptr> const& suites_, std::set<std::size_t> const& used_) {
+        std::for_each(used_.begin(), used_.end(), [&](std::size_t s_) { suites_[s_]->finish_units(); });
+    }
+
+    tcp_socket m_sock;
+};
+#endif
+}  // namespace net
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_NET_WORKER_HPP
@@ -0,0 +1,209 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_RANDOM_HPP
+#define TPP_RANDOM_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace tpp
+{
+namespace intern
+{
+namespace random
+{
+/// Pseudo random number generator xoshiro256**, which is fast, small, and satisfies UniformRandomBitGenerator.
+class engine final
+{
+public:
+    using result_type = std::uint64_t;
+
+    explicit engine(std::uint64_t seed_) {
+        for (auto& s : m_state) {
+            s = splitmix(seed_);
+        }
+    }
+
+    static constexpr auto
+    min() -> result_type {
+        return 0;
+    }
+
+    static constexpr auto
+    max() -> result_type {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    auto
+    operator()() -> result_type {
+        auto const res{rotl(m_state[1] * 5, 7) * 9};
+        auto const t{m_state[1] << 17};
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+        return res;
+    }
+
+    /// Advance x_ and get the next value of the splitmix64 sequence, which is used for seeding.
+    static auto
+    splitmix(std::uint64_t& x_) -> std::uint64_t {
+        auto z{x_ += 0x9e3779b97f4a7c15ULL};
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+private:
+    static auto
+    rotl(std::uint64_t x_, int k_) -> std::uint64_t {
+        return (x_ << k_) | (x_ >> (64 - k_));
+    }
+
+    std::uint64_t m_state[4];
+};
+
+/**
+ * The random numbers of a run of a testcase. The engine is seeded on first use from the global seed, the names of
+ * the testsuite and testcase, and the index of a generated case. Hence a run can be replayed by the same global seed.
+ */
+class source final
+{
+public:
+    class scope final
+    {
+    public:
+        explicit scope(source* s_) : m_prev(current()) {
+            current() = s_;
+        }
+
+        ~scope() noexcept {
+            current() = m_prev;
+        }
+
+        scope(scope const&) = delete;
+        auto
+        operator=(scope const&) -> scope& = delete;
+
+    private:
+        source* m_prev;
+    };
+
+    source(char const* suite_, char const* test_) : m_suite(suite_), m_test(test_) {
+        case_index() = 0;
+    }
+    source(source const&) = delete;
+    auto
+    operator=(source const&) -> source& = delete;
+
+    /// Get the source of the testcase, that runs in the current thread, or nullptr outside of testcases.
+    static auto
+    current() -> source*& {
+        static thread_local source* s{nullptr};
+        return s;
+    }
+
+    /// Get the global seed, which is random, unless it is set by --seed.
+    static auto
+    seed() -> std::atomic<std::uint64_t>& {
+        static std::atomic<std::uint64_t> s{random_seed()};
+        return s;
+    }
+
+    /// Get a new random seed, as used when no seed is given.
+    static inline auto
+    random_seed() -> std::uint64_t {
+        return static_cast<std::uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    }
+
+    /// Get the index of the generated case, that runs in the current thread. It is reset by every new source.
+    static auto
+    case_index() -> std::size_t& {
+        static thread_local std::size_t i{0};
+        return i;
+    }
+
+    /// Get an engine, that is private to the current thread, for use outside of testcases.
+    static auto
+    thread_engine() -> engine& {
+        static std::atomic<std::uint64_t> threads{0};
+        static thread_local engine        e(seed() ^ (++threads * 0x9e3779b97f4a7c15ULL));
+        return e;
+    }
+
+    auto
+    get() -> engine& {
+        if (!m_used) {
+            auto x{seed().load() ^ hash(m_suite) ^ (hash(m_test) * 31) ^ case_index()};
+            m_engine = engine(engine::splitmix(x));
+            m_used   = true;
+        }
+        return m_engine;
+    }
+
+    /// Check whether random numbers were used in this run.
+    inline auto
+    used() const -> bool {
+        return m_used;
+    }
+
+private:
+    /// FNV-1a hash of a name.
+    static auto
+    hash(char const* str_) -> std::uint64_t {
+        std::uint64_t h{0xcbf29ce484222325ULL};
+        for (auto const* c{str_}; *c; ++c) {
+            h = (h ^ static_cast<unsigned char>(*c)) * 0x100000001b3ULL;
+        }
+        return h;
+    }
+
+    char const* m_suite;
+    char const* m_test;
+    engine      m_engine{0};
+    bool        m_used{false};
+};
+}  // namespace random
+}  // namespace intern
+
+/**
+ * Get a random number generator, which is private to the current run of a testcase, and needs no locking.
+ * It is seeded deterministically from the global seed, and the names of testsuite and testcase. The global seed is
+ * printed in the reasons of unsuccessful testcases, that used it, and a run is replayed by passing it to --seed.
+ * Outside of testcases, like in further threads of a testcase, a generator private to the thread is returned, which
+ * is not reproducible.
+ *
+ * EXAMPLE:
+ * @code
+ * std::uniform_int_distribution<int> dist(1, 6);
+ * auto const roll{dist(tpp::rng())};
+ * @endcode
+ */
+inline auto
+rng() -> intern::random::engine& {
+    auto* s{intern::random::source::current()};
+    return s ? s->get() : intern::random::source::thread_engine();
+}
+}  // namespace tpp
+
+#endif  // TPP_RANDOM_HPP
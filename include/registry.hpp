@@ -0,0 +1,154 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_REGISTRY_HPP
+#define TPP_REGISTRY_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "test/fixture_store.hpp"
+#include "test/testsuite.hpp"
+
+/// Entry points of the global runner are defined in a separately compiled source, if TPP_COMPILED is set.
+#ifdef TPP_COMPILED
+#    define TPP_INTERN_RUNNER_LINKAGE
+#else
+#    define TPP_INTERN_RUNNER_LINKAGE inline
+#endif
+
+namespace tpp
+{
+namespace intern
+{
+struct suite_descriptor;
+struct test_descriptor;
+
+/**
+ * Intrusive lists of all statically registered testsuites in order of registration, and of their testcases in no
+ * particular order.
+ */
+struct suite_registry final
+{
+    suite_descriptor*                     head;
+    suite_descriptor*                     tail;
+    std::size_t                           count;
+    std::chrono::steady_clock::time_point first;  ///< When the first testsuite was registered.
+    test_descriptor const*                tests;
+};
+
+/**
+ * Get the lists of statically registered testsuites, and testcases, which are shared by all modules.
+ */
+TPP_INTERN_RUNNER_LINKAGE auto
+registered_suites() -> suite_registry&;
+
+/**
+ * Statically allocated descriptor of a testsuite, which appends itself to the list of registered testsuites.
+ * The testsuite, and its testcases are created by the runner on first use, hence registration allocates nothing.
+ */
+struct suite_descriptor final
+{
+    using create_function = test::testsuite_ptr (*)();
+
+    suite_descriptor(char const* name_, create_function create_) noexcept : name(name_), create(create_) {
+        auto& reg{registered_suites()};
+        if (reg.tail) {
+            reg.tail->next = this;
+        } else {
+            reg.head  = this;
+            reg.first = std::chrono::steady_clock::now();
+        }
+        reg.tail = this;
+        ++reg.count;
+    }
+
+    suite_descriptor(suite_descriptor const&) = delete;
+    auto
+    operator=(suite_descriptor const&) -> suite_descriptor& = delete;
+
+    char const* const     name;
+    create_function const create;
+    suite_descriptor*     next{nullptr};
+};
+
+/// Declaration of a testcase, or generator in a testsuite.
+struct test_declaration final
+{
+    suite_descriptor const* suite;
+    char const*             name;
+    char const*             file;
+    std::size_t             line;
+};
+
+/// Statically allocated descriptor of a testcase, which is known without creating its testsuite.
+struct test_descriptor final
+{
+    explicit test_descriptor(test_declaration const& decl_) noexcept : decl(decl_) {
+        auto& reg{registered_suites()};
+        next      = reg.tests;
+        reg.tests = this;
+    }
+
+    test_descriptor(test_descriptor const&) = delete;
+    auto
+    operator=(test_descriptor const&) -> test_descriptor& = delete;
+
+    test_declaration const decl;
+    test_descriptor const* next;
+};
+
+/**
+ * Registration of the testcase, which is declared by T. As a static member of a template it is registered during
+ * static initialization, but in unspecified order.
+ */
+template<typename T>
+struct test_registration final
+{
+    static test_descriptor const desc;
+};
+
+template<typename T>
+test_descriptor const test_registration<T>::desc{T::tpp_intern_declaration_()};
+
+/// Create the testsuite of a module, which owns the module, as its testcases refer to it.
+template<typename T>
+auto
+create_suite() -> test::testsuite_ptr {
+    std::shared_ptr<T> mod{std::make_shared<T>()};
+    auto               ts{mod->tpp_intern_release_()};
+    ts->own(std::move(mod));
+    return ts;
+}
+
+/**
+ * Get the store of global fixtures, which is owned by the global runner.
+ */
+TPP_INTERN_RUNNER_LINKAGE auto
+global_fixtures() -> test::fixture_store&;
+
+/**
+ * Run all registered testsuites by the global runner, configured by commandline arguments.
+ */
+TPP_INTERN_RUNNER_LINKAGE auto
+run_main(int argc_, char const** argv_) -> int;
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_REGISTRY_HPP
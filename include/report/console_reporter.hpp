@@ -58,7 +58,11 @@ private:
 
     void
     report_testcase(test::testcase const& tc_) override {
-        *this << fmt::SPACE << tc_.name() << " (" << tc_.elapsed_time() << "ms)" << fmt::LF << fmt::SPACE << fmt::SPACE;
+        *this << fmt::SPACE << tc_.name() << " (" << tc_.elapsed_time() << "ms";
+        if (tc_.arena_peak() > 0) {
+            *this << ", arena: " << tc_.arena_peak() << " bytes";
+        }
+        *this << ")" << fmt::LF << fmt::SPACE << fmt::SPACE;
         if (capture()) {
             *this << "stdout = \"" << escaped_string(tc_.cout()) << '"' << fmt::LF << fmt::SPACE << fmt::SPACE;
             *this << "stderr = \"" << escaped_string(tc_.cerr()) << '"' << fmt::LF << fmt::SPACE << fmt::SPACE;
@@ -68,6 +72,15 @@ private:
             case test::testcase::HAS_FAILED: *this << color().BLUE << "FAILED! " << tc_.reason(); break;
             default: *this << color().GREEN << "PASSED!"; break;
         }
+        if (tc_.quarantined()) {
+            *this << color().YELLOW << " [quarantined]";
+        }
+        if (!tc_.attempts().empty()) {
+            *this << color().YELLOW << (tc_.flaky() ? " [flaky]" : "") << " attempts:";
+            for (auto const& a : tc_.attempts()) {
+                *this << " (" << a.elapsed_t << "ms)";
+            }
+        }
         *this << color() << fmt::LF;
     }
 
@@ -82,7 +95,14 @@ private:
         }
         *this << "=== Result ===" << fmt::LF << "passes: " << abs_tests() - faults() << '/' << abs_tests()
               << " failures: " << abs_fails() << '/' << abs_tests() << " errors: " << abs_errs() << '/' << abs_tests()
-              << " (" << abs_time() << "ms)" << color() << fmt::LF;
+              << " (" << abs_time() << "ms)";
+        if (abs_flaky() > 0) {
+            *this << " flaky: " << abs_flaky();
+        }
+        if (quarantined() > 0) {
+            *this << " quarantined: " << quarantined();
+        }
+        *this << color() << fmt::LF;
     }
 };
 }  // namespace report
@@ -81,6 +81,29 @@ private:
         json_property_string("name", tc_.name(), true, color().W_BOLD);
         json_property_string("result", std::get<0>(dres), true, std::get<1>(dres));
         json_property_string("reason", tc_.reason(), true, std::get<1>(dres));
+        if (tc_.flaky()) {
+            json_property_value("flaky", "true", true, color().YELLOW);
+        }
+        if (tc_.quarantined()) {
+            json_property_value("quarantined", "true", true, color().YELLOW);
+        }
+        if (!tc_.attempts().empty()) {
+            *this << "\"attempts\":";
+            space();
+            *this << '[';
+            for (std::size_t i{0}; i < tc_.attempts().size(); ++i) {
+                if (i > 0) {
+                    *this << ',';
+                    space();
+                }
+                *this << tc_.attempts()[i].elapsed_t;
+            }
+            *this << "],";
+            newline();
+        }
+        if (tc_.arena_peak() > 0) {
+            json_property_value("arena", tc_.arena_peak(), true);
+        }
         json_property_value("time", tc_.elapsed_time(), capture());
         if (capture()) {
             json_property_string("stdout", tc_.cout(), true);
@@ -113,6 +136,12 @@ private:
         json_property_value("passes", abs_tests() - faults(), true, color().GREEN);
         json_property_value("failures", abs_fails(), true, color().BLUE);
         json_property_value("errors", abs_errs(), true, color().RED);
+        if (abs_flaky() > 0) {
+            json_property_value("flaky", abs_flaky(), true, color().YELLOW);
+        }
+        if (quarantined() > 0) {
+            json_property_value("quarantined", quarantined(), true, color().YELLOW);
+        }
         json_property_value("time", abs_time(), false);
         pop_indent();
         newline();
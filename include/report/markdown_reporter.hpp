@@ -59,8 +59,7 @@ private:
         reporter::report_testsuite(ts_);
 
         *this << fmt::LF;
-        std::for_each(ts_->testcases().cbegin(), ts_->testcases().cend(),
-                      [this](test::testcase const& tc_) { testcase_details(tc_); });
+        for_each_testcase(ts_, [this](test::testcase const& tc_) { testcase_details(tc_); });
     }
 
     void
@@ -69,10 +68,11 @@ private:
             switch (tc_.result()) {
                 case test::testcase::HAD_ERROR: return "ERROR";
                 case test::testcase::HAS_FAILED: return "FAILED";
-                default: return "PASSED";
+                default: return tc_.flaky() ? "PASSED (flaky)" : "PASSED";
             }
         };
-        *this << '|' << tc_.name() << '|' << tc_.elapsed_time() << "ms|" << status() << '|' << fmt::LF;
+        *this << '|' << tc_.name() << '|' << tc_.elapsed_time() << "ms|" << status()
+              << (tc_.quarantined() ? " (quarantined)" : "") << '|' << fmt::LF;
     }
 
     void
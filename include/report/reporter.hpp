@@ -29,6 +29,8 @@
 
 #include "test/testsuite.hpp"
 
+#include "fatal.hpp"
+
 namespace tpp
 {
 namespace intern
@@ -77,6 +79,8 @@ public:
         m_abs_errs  = 0;
         m_abs_fails = 0;
         m_abs_tests = 0;
+        m_abs_flaky = 0;
+        m_abs_quar  = 0;
         m_abs_time  = .0;
     };
 
@@ -88,6 +92,12 @@ public:
         return m_abs_errs + m_abs_fails;
     }
 
+    /// Get the number of faults of quarantined testcases, which are included in faults.
+    inline auto
+    quarantined() const -> std::size_t {
+        return m_abs_quar;
+    }
+
     auto
     with_color() -> reporter_ptr {
         m_colors.RED     = fmt::ansi::RED;
@@ -136,13 +146,13 @@ protected:
 
     explicit reporter(std::ostream& stream_) : m_out_stream(stream_) {
         if (!m_out_stream) {
-            throw std::runtime_error("could not open stream for report");
+            TPP_INTERN_THROW(std::runtime_error("could not open stream for report"));
         }
     }
 
     explicit reporter(std::string const& fname_) : m_out_file(fname_), m_out_stream(m_out_file) {
         if (!m_out_stream) {
-            throw std::runtime_error("could not open file for report");
+            TPP_INTERN_THROW(std::runtime_error("could not open file for report"));
         }
     }
 
@@ -151,14 +161,28 @@ protected:
         m_abs_errs += ts_->statistics().errors();
         m_abs_fails += ts_->statistics().failures();
         m_abs_tests += ts_->statistics().tests();
+        m_abs_flaky += ts_->statistics().flaky();
+        m_abs_quar += ts_->statistics().quarantined();
         m_abs_time += ts_->statistics().elapsed_time();
-        std::for_each(ts_->testcases().begin(), ts_->testcases().end(),
-                      [this](test::testcase const& tc_) { report_testcase(tc_); });
+        for_each_testcase(ts_, [this](test::testcase const& tc_) { report_testcase(tc_); });
     }
 
     virtual void
     report_testcase(test::testcase const& tc_) = 0;
 
+    /// Visit each testcase of a testsuite, where a testcase with sections is replaced by the records of its sections.
+    template<typename Fn>
+    static void
+    for_each_testcase(test::testsuite_ptr const& ts_, Fn&& fn_) {
+        std::for_each(ts_->testcases().cbegin(), ts_->testcases().cend(), [&](test::testcase const& tc_) {
+            if (tc_.sections().empty()) {
+                fn_(tc_);
+            } else {
+                std::for_each(tc_.sections().cbegin(), tc_.sections().cend(), fn_);
+            }
+        });
+    }
+
     template<typename T>
     auto
     operator<<(T&& t_) const -> std::ostream& {
@@ -217,6 +241,11 @@ protected:
         return m_abs_errs;
     }
 
+    inline auto
+    abs_flaky() const -> std::size_t {
+        return m_abs_flaky;
+    }
+
     inline auto
     abs_time() const -> double {
         return m_abs_time;
@@ -237,6 +266,8 @@ private:
     std::size_t   m_abs_tests{0};
     std::size_t   m_abs_fails{0};
     std::size_t   m_abs_errs{0};
+    std::size_t   m_abs_flaky{0};
+    std::size_t   m_abs_quar{0};
     double        m_abs_time{0};
 };
 }  // namespace report
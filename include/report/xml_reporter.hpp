@@ -80,7 +80,20 @@ private:
             *this << '>';
             push_indent();
             newline();
-            *this << '<' << unsuccess() << " message=\"" << tc_.reason() << "\"></" << unsuccess() << '>';
+            *this << '<' << unsuccess() << " message=\"" << tc_.reason() << '"'
+                  << (tc_.quarantined() ? " type=\"quarantined\"" : "") << "></" << unsuccess() << '>';
+            pop_indent();
+            print_system_out(tc_);
+            newline();
+            *this << "</testcase>";
+        } else if (tc_.flaky()) {
+            *this << '>';
+            push_indent();
+            for (auto const& a : tc_.attempts()) {
+                auto const flaky{a.result == test::testcase::HAD_ERROR ? "flakyError" : "flakyFailure"};
+                newline();
+                *this << '<' << flaky << " message=\"" << a.reason << "\" time=\"" << a.elapsed_t << "\"/>";
+            }
             pop_indent();
             print_system_out(tc_);
             newline();
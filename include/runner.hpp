@@ -19,13 +19,53 @@
 #define TPP_RUNNER_HPP
 
 #include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "net/coordinator.hpp"
+#include "net/worker.hpp"
 #include "report/reporter.hpp"
+#include "test/fixture_store.hpp"
+#include "test/quarantine.hpp"
 #include "test/testsuite.hpp"
 #include "test/testsuite_parallel.hpp"
 
 #include "cmdline_parser.hpp"
+#include "coverage.hpp"
+#include "cpp_meta.hpp"
+#include "duration.hpp"
+#include "fatal.hpp"
+#include "isolation.hpp"
+#include "journal.hpp"
+#include "listener.hpp"
+#include "random.hpp"
+#include "registry.hpp"
+#include "stringify.hpp"
+#include "temp_dir.hpp"
+#include "watcher.hpp"
+
+#ifdef _OPENMP
+#    include <omp.h>
+#endif
+
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+#    include <dlfcn.h>
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <unistd.h>
+#endif
 
 namespace tpp
 {
@@ -42,48 +82,134 @@ class runner
 public:
     void
     add_testsuite(test::testsuite_ptr const& ts_) {
+        if (this == &instance()) {
+            collect();
+        }
         m_testsuites.push_back(ts_);
+        m_registered.push_back(nullptr);
     }
 
     auto
     run(int argc_, char const** argv_) noexcept -> int {
         cmdline_parser cmd;
+        if (argc_ < 0) {
+            return err_exit("argument count cannot be less than zero!");
+        }
+#ifdef TPP_INTERN_NO_EXCEPTIONS
+        cmd.parse(static_cast<std::size_t>(argc_), argv_);
+        if (cmd.help()) {
+            return to_int(retval::HELP);
+        }
+#else
         try {
-            if (argc_ < 0) {
-                throw std::runtime_error("argument count cannot be less than zero!");
-            }
             cmd.parse(static_cast<std::size_t>(argc_), argv_);
         } catch (cmdline_parser::help_called) {
             return to_int(retval::HELP);
         } catch (std::runtime_error const& e) {
             return err_exit(e.what());
         }
+#endif
         return run(cmd.config());
     }
 
+    /**
+     * Load a shared library module, which adds its testsuites to this runner. The module is never unloaded.
+     * Modules register their testsuites in the global runner instance, hence the host binary must export its symbols
+     * (-rdynamic), so that modules share this instance.
+     */
+    void
+    load(char const* path_) {
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+        auto* const h{::dlopen(path_, RTLD_NOW | RTLD_NOLOAD)};
+        if (h) {
+            ::dlclose(h);
+            TPP_INTERN_THROW(std::runtime_error(std::string(path_) + " is already loaded"));
+        }
+        auto ts{open_module(path_)};
+        if (ts.empty()) {
+            TPP_INTERN_THROW(
+              std::runtime_error(std::string(path_) + " added no testsuites, is the binary linked with -rdynamic?"));
+        }
+        std::for_each(ts.begin(), ts.end(), [this](test::testsuite_ptr const& t_) { add_testsuite(t_); });
+        m_modules[path_] = std::move(ts);
+#else
+        static_cast<void>(path_);
+        TPP_INTERN_THROW(std::runtime_error("loading modules is " TPP_INTERN_NO_SYS_FEATURES));
+#endif
+    }
+
+    /**
+     * Load a fresh copy of a module, whose testsuites replace those of its previous copy.
+     * Previous copies are never unloaded, so that global fixtures they created stay valid. As GCC would bind the
+     * static objects of a copy to those of its predecessor, reloaded modules must be built with -fno-gnu-unique.
+     * Copies are anonymous in-memory files, so that no other user can replace them before they are loaded.
+     * @return the new testsuites of the module.
+     */
+    auto
+    reload(char const* path_) -> std::vector<test::testsuite_ptr> {
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+        auto const                       fd{copy_module(path_)};
+        std::vector<test::testsuite_ptr> ts;
+        try {
+            ts = open_module(("/proc/self/fd/" + std::to_string(fd)).c_str());
+        } catch (std::runtime_error const&) {
+            ::close(fd);
+            throw;
+        }
+        // A loaded copy is never closed, like it is never unloaded, so that its path is not reused by the next copy.
+        if (ts.empty()) {
+            TPP_INTERN_THROW(
+              std::runtime_error(std::string(path_) + " added no testsuites, is it built with -fno-gnu-unique?"));
+        }
+        auto&       prev{m_modules[path_]};
+        std::size_t kept{0};
+        for (std::size_t i{0}; i < m_testsuites.size(); ++i) {
+            if (std::find(prev.begin(), prev.end(), m_testsuites[i]) == prev.end()) {
+                m_testsuites[kept] = std::move(m_testsuites[i]);
+                m_registered[kept] = m_registered[i];
+                ++kept;
+            }
+        }
+        m_testsuites.resize(kept);
+        m_registered.resize(kept);
+        std::for_each(ts.begin(), ts.end(), [this](test::testsuite_ptr const& t_) { add_testsuite(t_); });
+        prev = ts;
+        return ts;
+#else
+        static_cast<void>(path_);
+        TPP_INTERN_THROW(std::runtime_error("loading modules is " TPP_INTERN_NO_SYS_FEATURES));
+#endif
+    }
+
+    /// Add a listener, which is notified of the results of all following runs alongside the reporter.
+    void
+    add_listener(listener_ptr const& l_) {
+        m_listeners.add(l_);
+    }
+
+    /// Get the store of global fixtures.
+    inline auto
+    fixtures() -> test::fixture_store& {
+        return m_fixtures;
+    }
+
     auto
     run(config const& cfg_) noexcept -> int {
-        bool const fm_inc{cfg_.f_mode != config::filter_mode::EXCLUDE};
+#ifdef TPP_INTERN_NO_EXCEPTIONS
+        return profiled(cfg_);
+#else
         try {
-            auto rep{cfg_.reporter()};
-            rep->begin_report();
-            std::for_each(m_testsuites.begin(), m_testsuites.end(), [&](test::testsuite_ptr& ts_) {
-                bool const match{
-                  cfg_.f_patterns.empty() ||
-                  std::any_of(cfg_.f_patterns.cbegin(), cfg_.f_patterns.cend(),
-                              [&](std::regex const& re_) -> bool { return std::regex_match(ts_->name(), re_); })};
-                if (fm_inc == match) {
-                    ts_->run();
-                    rep->report(ts_);
-                }
-            });
-            rep->end_report();
-            return static_cast<int>(std::min(rep->faults(), static_cast<std::size_t>(std::numeric_limits<int>::max())));
+            return profiled(cfg_);
         } catch (std::runtime_error const& e) {
             return err_exit(e.what());
         }
+#endif
     }
 
+    /**
+     * Get the global runner, which takes all statically registered testsuites, when it runs, or loads a module.
+     * As it is accessed by testcases for global fixtures, this does not modify it.
+     */
     static auto
     instance() -> runner& {
         static runner r;
@@ -91,6 +217,567 @@ public:
     }
 
 private:
+    /// Time spent on creating testsuites, which were registered statically.
+    struct startup_profile
+    {
+        std::size_t registered{0};
+        double      since_registration_t{0.0};  ///< From the first registration until the runner started.
+        std::size_t created{0};
+        std::size_t testcases{0};
+        double      creation_t{0.0};
+    };
+
+    /// Append all testsuites, that were registered statically since the last call, without creating them.
+    void
+    collect() {
+        auto const& reg{registered_suites()};
+        if (!m_collected && reg.head) {
+            m_profile.registered = reg.count;
+            m_profile.since_registration_t =
+              std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - reg.first).count();
+        }
+        for (auto const* d{m_collected ? m_collected->next : reg.head}; d; d = d->next) {
+            m_testsuites.emplace_back();
+            m_registered.push_back(d);
+            m_collected = d;
+        }
+    }
+
+    /// Get a testsuite, which is created on first use, if it was registered statically.
+    auto
+    suite(std::size_t i_) -> test::testsuite_ptr const& {
+        auto& ts{m_testsuites[i_]};
+        if (!ts) {
+            duration d;
+            ts = m_registered[i_]->create();
+            m_profile.creation_t += d.get();
+            m_profile.testcases += ts->testcases().size() + ts->generators().size();
+            ++m_profile.created;
+        }
+        return ts;
+    }
+
+    /// Create all testsuites, as their indices are shared with other processes.
+    void
+    create_all() {
+        for (std::size_t i{0}; i < m_testsuites.size(); ++i) {
+            suite(i);
+        }
+    }
+
+    /// Get the name of a testsuite, without creating it.
+    auto
+    name(std::size_t i_) const -> char const* {
+        return m_testsuites[i_] ? m_testsuites[i_]->name() : m_registered[i_]->name;
+    }
+
+    /// Discard registered testsuites, that were created by a previous run, so that each run creates them afresh.
+    void
+    renew() {
+        for (std::size_t i{0}; i < m_testsuites.size(); ++i) {
+            if (m_registered[i]) {
+                m_testsuites[i].reset();
+            }
+        }
+    }
+
+    /// Run with fresh testsuites, and print the startup profile to stderr afterwards, if requested.
+    auto
+    profiled(config const& cfg_) -> int {
+        if (this == &instance()) {
+            collect();
+        }
+        renew();
+        m_profile.created    = 0;
+        m_profile.testcases  = 0;
+        m_profile.creation_t = 0.0;
+        auto const ret{dispatch(cfg_)};
+        if (cfg_.startup_profile) {
+            std::cerr << "Startup profile:\n  registration: " << m_profile.registered << " testsuites, the first "
+                      << m_profile.since_registration_t << " ms before the run\n  creation    : " << m_profile.created
+                      << " testsuites with " << m_profile.testcases << " testcases in " << m_profile.creation_t
+                      << " ms" << std::endl;
+        }
+        return ret;
+    }
+
+    auto
+    dispatch(config const& cfg_) -> int {
+        std::for_each(cfg_.modules.cbegin(), cfg_.modules.cend(), [this](std::string const& m_) { load(m_.c_str()); });
+        if (!cfg_.journal.empty() && cfg_.dist != config::dist_mode::LOCAL) {
+            TPP_INTERN_THROW(std::runtime_error("journals are only supported for local runs"));
+        }
+        if (cfg_.run_cfg.retries > 0 && (!cfg_.journal.empty() || cfg_.dist != config::dist_mode::LOCAL)) {
+            TPP_INTERN_THROW(std::runtime_error("retries are only supported for local runs without journal"));
+        }
+        if (!cfg_.coverage_map.empty() &&
+            (!cfg_.journal.empty() || cfg_.dist != config::dist_mode::LOCAL || cfg_.watch)) {
+            TPP_INTERN_THROW(std::runtime_error("coverage maps are only supported for local runs without journal"));
+        }
+        if (cfg_.isolate && (!cfg_.journal.empty() || cfg_.dist != config::dist_mode::LOCAL || cfg_.watch ||
+                             !cfg_.coverage_map.empty() || cfg_.run_cfg.retries > 0)) {
+            TPP_INTERN_THROW(std::runtime_error("isolation by fork is only supported for plain local runs"));
+        }
+        if (cfg_.impact && cfg_.coverage_map.empty()) {
+            TPP_INTERN_THROW(std::runtime_error("selecting testcases by changed files requires a coverage map"));
+        }
+        if (cfg_.list) {
+            return list(cfg_);
+        }
+        // An empty quarantine clears the marks of testsuites, that were quarantined by a previous run.
+        m_quarantine = cfg_.quarantine.empty() ? std::make_shared<test::quarantine const>() :
+                                                 load_quarantine(cfg_.quarantine);
+        temp_dir::keep_failed() = cfg_.keep_temp;
+        random::source::seed()  = cfg_.seeded ? cfg_.seed : random::source::random_seed();
+        if (cfg_.watch) {
+            return watch(cfg_);
+        }
+        switch (cfg_.dist) {
+            case config::dist_mode::SERVE: return serve(cfg_);
+            case config::dist_mode::WORKER: return work(cfg_);
+            default: break;
+        }
+        if (cfg_.impact) {
+            return impacted(cfg_);
+        }
+        if (!cfg_.coverage_map.empty()) {
+            return covered(cfg_);
+        }
+        if (cfg_.isolate) {
+            return isolated(cfg_);
+        }
+        return cfg_.journal.empty() ? report(selected(cfg_), cfg_, true) : journaled(cfg_);
+    }
+
+    /**
+     * List the testcases of all selected testsuites, without creating them. Registered testsuites are listed from the
+     * descriptors of their testcases in order of declaration, others only by the names of their testcases.
+     */
+    auto
+    list(config const& cfg_) -> int {
+        std::map<suite_descriptor const*, std::vector<test_declaration>> decls;
+        for (auto const* t{registered_suites().tests}; t; t = t->next) {
+            decls[t->decl.suite].push_back(t->decl);
+        }
+        std::ofstream file;
+        if (!cfg_.report_cfg.outfile.empty()) {
+            file.open(cfg_.report_cfg.outfile);
+            if (!file) {
+                TPP_INTERN_THROW(std::runtime_error("could not open " + cfg_.report_cfg.outfile));
+            }
+        }
+        std::ostream& out{file.is_open() ? file : (cfg_.report_cfg.ostream ? *cfg_.report_cfg.ostream : std::cout)};
+        auto const    json{cfg_.report_fmt == config::report_format::JSON};
+        auto          first{true};
+        auto const    print{[&](char const* suite_, char const* test_, char const* file_, std::size_t line_) {
+            if (!json) {
+                out << suite_ << '/' << test_;
+                if (file_) {
+                    out << '\t' << file_ << ':' << line_;
+                }
+                out << '\n';
+                return;
+            }
+            out << (first ? "\n" : ",\n") << "  {\"suite\":\"" << escaped_string(suite_) << "\",\"test\":\""
+                << escaped_string(test_) << '"';
+            if (file_) {
+                out << ",\"file\":\"" << escaped_string(file_) << "\",\"line\":" << line_;
+            }
+            out << '}';
+            first = false;
+        }};
+        if (json) {
+            out << '[';
+        }
+        for (std::size_t i{0}; i < m_testsuites.size(); ++i) {
+            if (!cfg_.selects(name(i))) {
+                continue;
+            }
+            if (!m_registered[i]) {
+                for (auto const& tc : m_testsuites[i]->testcases()) {
+                    print(name(i), tc.name(), nullptr, 0);
+                }
+                for (auto const& gen : m_testsuites[i]->generators()) {
+                    print(name(i), gen.name(), nullptr, 0);
+                }
+                continue;
+            }
+            auto& d{decls[m_registered[i]]};
+            std::sort(d.begin(), d.end(), [](test_declaration const& l_, test_declaration const& r_) {
+                return std::make_pair(std::string(l_.file), l_.line) < std::make_pair(std::string(r_.file), r_.line);
+            });
+            for (auto const& t : d) {
+                print(name(i), t.name, t.file, t.line);
+            }
+        }
+        if (json) {
+            out << (first ? "]\n" : "\n]\n");
+        }
+        out.flush();
+        return 0;
+    }
+
+    /**
+     * Get the indices of all testsuites, that are selected by filters, and create them. If requested, testsuites that
+     * share a global fixture are moved next to the first of them, so that the fixture is released early.
+     */
+    auto
+    selected(config const& cfg_) -> std::vector<std::size_t> {
+        std::vector<std::size_t> sel;
+        for (std::size_t i{0}; i < m_testsuites.size(); ++i) {
+            if (cfg_.selects(name(i))) {
+                suite(i);
+                sel.push_back(i);
+            }
+        }
+        if (!cfg_.group_fixtures) {
+            return sel;
+        }
+        std::vector<std::size_t> grouped;
+        std::vector<bool>        placed(sel.size(), false);
+        for (std::size_t i{0}; i < sel.size(); ++i) {
+            if (placed[i]) {
+                continue;
+            }
+            auto const& fx{m_testsuites[sel[i]]->fixtures()};
+            grouped.push_back(sel[i]);
+            for (std::size_t j{i + 1}; j < sel.size(); ++j) {
+                auto const& other{m_testsuites[sel[j]]->fixtures()};
+                if (!placed[j] && std::find_first_of(fx.begin(), fx.end(), other.begin(), other.end()) != fx.end()) {
+                    grouped.push_back(sel[j]);
+                    placed[j] = true;
+                }
+            }
+        }
+        return grouped;
+    }
+
+    /**
+     * Count the selected testsuites as users of the global fixtures they declared. Global fixtures are always kept in
+     * the store of the global runner instance, as testsuites declare them there.
+     */
+    void
+    acquire_fixtures(std::vector<std::size_t> const& sel_) {
+        for (auto i : sel_) {
+            for (auto const& f : m_testsuites[i]->fixtures()) {
+                instance().m_fixtures.acquire(f);
+            }
+        }
+    }
+
+    /// Release the global fixtures of a testsuite, that has finished.
+    static void
+    release_fixtures(test::testsuite const& ts_) {
+        for (auto const& f : ts_.fixtures()) {
+            instance().m_fixtures.release(f);
+        }
+    }
+
+    /**
+     * Run, and report the selected testsuites. Listeners are notified of each testcase as soon as it finished, unless
+     * the testsuites were run already, or are retried. Then they are notified of all results before the report.
+     * With retries all testsuites are run first, so that failed testcases are
+     * retried after the main pass. Failures of quarantined testcases do not count for the exit code.
+     */
+    auto
+    report(std::vector<std::size_t> const& sel_, config const& cfg_, bool run_) -> int {
+        auto const scoped{run_ && !cfg_.watch};
+        if (scoped) {
+            acquire_fixtures(sel_);
+        }
+        if (run_ && cfg_.run_cfg.retries > 0) {
+            std::for_each(sel_.begin(), sel_.end(), [&](std::size_t i_) { m_testsuites[i_]->run(cfg_.run_cfg); });
+            std::for_each(sel_.begin(), sel_.end(), [&](std::size_t i_) {
+                m_testsuites[i_]->retry(cfg_.run_cfg.retries);
+                if (scoped) {
+                    release_fixtures(*m_testsuites[i_]);
+                }
+            });
+        }
+        auto rep{cfg_.reporter()};
+        auto run_cfg{cfg_.run_cfg};
+        m_listeners.run_start();
+        rep->begin_report();
+        std::for_each(sel_.begin(), sel_.end(), [&](std::size_t i_) {
+            auto const& ts{m_testsuites[i_]};
+            auto const  live{run_ && cfg_.run_cfg.retries == 0 && !ts->done()};
+            run_cfg.listeners = live && !m_listeners.empty() ? &m_listeners : nullptr;
+            m_listeners.suite_start(*ts);
+            if (run_) {
+                ts->run(run_cfg);
+                if (scoped && cfg_.run_cfg.retries == 0) {
+                    release_fixtures(*ts);
+                }
+            }
+            if (m_quarantine) {
+                ts->quarantine(*m_quarantine);
+            }
+            if (!live && !m_listeners.empty()) {
+                std::for_each(ts->testcases().begin(), ts->testcases().end(),
+                              [&](test::testcase const& tc_) { m_listeners.test_end(*ts, tc_); });
+            }
+            m_listeners.suite_end(*ts);
+            rep->report(ts);
+        });
+        rep->end_report();
+        m_listeners.run_end();
+        return static_cast<int>(
+          std::min(rep->faults() - rep->quarantined(), static_cast<std::size_t>(std::numeric_limits<int>::max())));
+    }
+
+    auto
+    serve(config const& cfg_) -> int {
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+        auto const       sel{selected(cfg_)};
+        net::coordinator coord(cfg_.dist_host, cfg_.dist_port);
+        std::cerr << "Serving testcases at port " << coord.port() << std::endl;
+        coord.run(m_testsuites, sel, cfg_.run_cfg);
+        return report(sel, cfg_, false);
+#else
+        static_cast<void>(cfg_);
+        TPP_INTERN_THROW(std::runtime_error("distributed execution is " TPP_INTERN_NO_SYS_FEATURES));
+#endif
+    }
+
+    auto
+    work(config const& cfg_) -> int {
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+        net::worker w(cfg_.dist_host, cfg_.dist_port);
+        create_all();
+#    ifdef _OPENMP
+        w.run(m_testsuites, static_cast<std::size_t>(std::max(1, omp_get_max_threads())));
+#    else
+        w.run(m_testsuites, 1);
+#    endif
+        return 0;
+#else
+        static_cast<void>(cfg_);
+        TPP_INTERN_THROW(std::runtime_error("distributed execution is " TPP_INTERN_NO_SYS_FEATURES));
+#endif
+    }
+
+    /// Run all units of work, that are not in the journal yet, and record their results.
+    auto
+    journaled(config const& cfg_) -> int {
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+        auto const sel{selected(cfg_)};
+        journal    j(cfg_.journal, cfg_.resume);
+        create_all();
+        j.replay(m_testsuites, cfg_.run_cfg);
+        acquire_fixtures(sel);
+        std::for_each(sel.begin(), sel.end(), [&](std::size_t i_) {
+            auto const& ts{m_testsuites[i_]};
+            auto        units{ts->units(journal::CHUNK)};
+            units.erase(std::remove_if(units.begin(), units.end(),
+                                       [&](test::work_unit const& u_) { return j.done(i_, u_); }),
+                        units.end());
+            if (!units.empty()) {
+                ts->run_units(units, cfg_.run_cfg, [&](std::size_t, test::unit_result&& r_) {
+                    j.record(i_, *ts, r_);
+                    ts->merge(std::move(r_), cfg_.run_cfg);
+                });
+                ts->finish_units();
+            }
+            ts->complete(cfg_.run_cfg);
+            release_fixtures(*ts);
+            j.flush();
+        });
+        return report(sel, cfg_, false);
+#else
+        static_cast<void>(cfg_);
+        TPP_INTERN_THROW(std::runtime_error("journals are " TPP_INTERN_NO_SYS_FEATURES));
+#endif
+    }
+
+    /**
+     * Run each testcase on its own, and record which source files it executed in a coverage map. Generators, and
+     * testcases with sections are recorded as a whole under their declared name. The coverage of SETUP is attributed
+     * to the first testcase of a testsuite.
+     */
+    auto
+    covered(config const& cfg_) -> int {
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+        auto const     sel{selected(cfg_)};
+        coverage_probe probe;
+        coverage_map   map;
+        acquire_fixtures(sel);
+        std::for_each(sel.begin(), sel.end(), [&](std::size_t i_) {
+            auto const& ts{m_testsuites[i_]};
+            for (auto const& u : ts->units(std::numeric_limits<std::size_t>::max())) {
+                probe.reset();
+                ts->run_units(std::vector<test::work_unit>{u}, cfg_.run_cfg, [&](std::size_t, test::unit_result&& r_) {
+                    map.record(std::string(ts->name()) + '/' + ts->context(u.item).tc_name, probe.collect());
+                    ts->merge(std::move(r_), cfg_.run_cfg);
+                });
+            }
+            ts->finish_units();
+            ts->complete(cfg_.run_cfg);
+            release_fixtures(*ts);
+        });
+        map.save(cfg_.coverage_map);
+        return report(sel, cfg_, false);
+#else
+        static_cast<void>(cfg_);
+        TPP_INTERN_THROW(std::runtime_error("coverage maps are " TPP_INTERN_NO_SYS_FEATURES));
+#endif
+    }
+
+    /// Run each testcase in a child process, which is forked after SETUP of its testsuite.
+    auto
+    isolated(config const& cfg_) -> int {
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+        auto const sel{selected(cfg_)};
+        acquire_fixtures(sel);
+        std::for_each(sel.begin(), sel.end(), [&](std::size_t i_) {
+            auto const& ts{m_testsuites[i_]};
+#    ifdef _OPENMP
+            auto const jobs{ts->parallel() ? static_cast<std::size_t>(std::max(1, omp_get_max_threads())) : 1};
+#    else
+            std::size_t const jobs{1};
+#    endif
+            fork_isolation(*ts, cfg_.run_cfg, jobs).run();
+            release_fixtures(*ts);
+        });
+        return report(sel, cfg_, false);
+#else
+        static_cast<void>(cfg_);
+        TPP_INTERN_THROW(std::runtime_error("isolation by fork is " TPP_INTERN_NO_SYS_FEATURES));
+#endif
+    }
+
+    /**
+     * Run only testcases, that executed any of the changed files according to the coverage map, and testcases that are
+     * not in the map. If any changed file is not in the map, all testcases are run.
+     */
+    auto
+    impacted(config const& cfg_) -> int {
+        auto const            map{coverage_map::load(cfg_.coverage_map)};
+        std::set<std::string> tests;
+        auto                  sel{selected(cfg_)};
+        if (!map.affected(cfg_.changed_files, tests)) {
+            std::cerr << "Changed files are not in the coverage map, running all testcases" << std::endl;
+            return report(sel, cfg_, true);
+        }
+        sel.erase(std::remove_if(sel.begin(), sel.end(),
+                                 [&](std::size_t i_) {
+                                     auto&      ts{*m_testsuites[i_]};
+                                     auto const prefix{std::string(ts.name()) + '/'};
+                                     ts.select([&](char const* name_) {
+                                         return tests.count(prefix + name_) > 0 || !map.contains(prefix + name_);
+                                     });
+                                     return ts.testcases().empty() && ts.generators().empty();
+                                 }),
+                  sel.end());
+        return report(sel, cfg_, true);
+    }
+
+    /// Run all testsuites, and afterwards rerun the testsuites of each module, whenever it was rebuilt.
+    auto
+    watch(config const& cfg_) -> int {
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+        if (cfg_.modules.empty() || cfg_.dist != config::dist_mode::LOCAL || !cfg_.journal.empty()) {
+            TPP_INTERN_THROW(
+              std::runtime_error("watching is only supported for local runs of modules without journal"));
+        }
+        watcher w(cfg_.modules);
+        report(selected(cfg_), cfg_, true);
+        for (;;) {
+            std::vector<test::testsuite_ptr> fresh;
+            for (auto const& path : w.wait()) {
+                try {
+                    auto const ts{reload(path.c_str())};
+                    fresh.insert(fresh.end(), ts.begin(), ts.end());
+                } catch (std::runtime_error const& e) {
+                    std::cerr << "Could not reload " << path << "\n  what(): " << e.what() << std::endl;
+                }
+            }
+            std::vector<std::size_t> sel;
+            for (std::size_t i{0}; i < m_testsuites.size(); ++i) {
+                if (cfg_.selects(name(i)) &&
+                    std::find(fresh.begin(), fresh.end(), m_testsuites[i]) != fresh.end()) {
+                    sel.push_back(i);
+                }
+            }
+            if (!sel.empty()) {
+                report(sel, cfg_, true);
+            }
+        }
+#else
+        static_cast<void>(cfg_);
+        TPP_INTERN_THROW(std::runtime_error("watching is " TPP_INTERN_NO_SYS_FEATURES));
+#endif
+    }
+
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+    /// Copy a module into an anonymous in-memory file. Returns its file descriptor.
+    auto
+    copy_module(char const* path_) -> int {
+        auto const name{"tpp-module-" + std::to_string(++m_reloads)};
+        auto const in{::open(path_, O_RDONLY | O_CLOEXEC)};
+        auto const out{::memfd_create(name.c_str(), MFD_CLOEXEC)};
+        bool       ok{in >= 0 && out >= 0};
+        char       buf[65536];
+        while (ok) {
+            auto const n{::read(in, buf, sizeof(buf))};
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                ok = n == 0;
+                break;
+            }
+            ok = ::write(out, buf, static_cast<std::size_t>(n)) == n;
+        }
+        if (in >= 0) {
+            ::close(in);
+        }
+        if (!ok) {
+            if (out >= 0) {
+                ::close(out);
+            }
+            TPP_INTERN_THROW(std::runtime_error(std::string("could not copy module ") + path_));
+        }
+        return out;
+    }
+
+    /// Open a shared library, and take the testsuites it registered from the global runner instance.
+    static auto
+    open_module(char const* file_) -> std::vector<test::testsuite_ptr> {
+        auto& host{instance()};
+        host.collect();
+        auto const first{host.m_testsuites.size()};
+        if (!::dlopen(file_, RTLD_NOW | RTLD_LOCAL)) {
+            TPP_INTERN_THROW(std::runtime_error(std::string("could not load module: ") + ::dlerror()));
+        }
+        host.collect();
+        std::vector<test::testsuite_ptr> ts;
+        for (auto i{first}; i < host.m_testsuites.size(); ++i) {
+            ts.push_back(host.suite(i));
+        }
+        host.m_testsuites.resize(first);
+        host.m_registered.resize(first);
+        return ts;
+    }
+#endif
+
+    /// Read a quarantine file, where each line is an entry. Empty lines, and lines starting with # are ignored.
+    static auto
+    load_quarantine(std::string const& path_) -> test::quarantine_ptr {
+        std::ifstream in(path_);
+        if (!in) {
+            TPP_INTERN_THROW(std::runtime_error("could not open quarantine file " + path_));
+        }
+        auto        q{std::make_shared<test::quarantine>()};
+        std::string line;
+        while (std::getline(in, line)) {
+            auto const end{line.find_last_not_of(" \t\r")};
+            if (end != std::string::npos && line.front() != '#') {
+                q->add(line.substr(0, end + 1));
+            }
+        }
+        return q;
+    }
+
     static inline auto
     to_int(retval v_) -> int {
         return static_cast<int>(v_);
@@ -102,8 +789,34 @@ private:
         return to_int(retval::EXCEPT);
     }
 
-    std::vector<test::testsuite_ptr> m_testsuites;
+    std::vector<test::testsuite_ptr>                        m_testsuites;  ///< Empty until a registered one is created.
+    std::vector<suite_descriptor const*>                    m_registered;  ///< Descriptors of registered testsuites.
+    suite_descriptor const*                                 m_collected{nullptr};
+    std::map<std::string, std::vector<test::testsuite_ptr>> m_modules;  ///< Testsuites of each loaded module.
+    std::size_t                                             m_reloads{0};
+    test::fixture_store                                     m_fixtures;
+    test::quarantine_ptr                                    m_quarantine;
+    startup_profile                                         m_profile;
+    listener_list                                           m_listeners;
 };
+
+#if !defined(TPP_COMPILED) || defined(TPP_INTERN_RUNNER_SOURCE)
+TPP_INTERN_RUNNER_LINKAGE auto
+registered_suites() -> suite_registry& {
+    static suite_registry reg{nullptr, nullptr, 0, {}, nullptr};
+    return reg;
+}
+
+TPP_INTERN_RUNNER_LINKAGE auto
+global_fixtures() -> test::fixture_store& {
+    return runner::instance().fixtures();
+}
+
+TPP_INTERN_RUNNER_LINKAGE auto
+run_main(int argc_, char const** argv_) -> int {
+    return runner::instance().run(argc_, argv_);
+}
+#endif
 }  // namespace intern
 
 using runner = intern::runner;
@@ -28,7 +28,6 @@
 #include <utility>
 
 #include "cpp_meta.hpp"
-#include "regex.hpp"
 #include "traits.hpp"
 
 #ifdef TPP_INTERN_SYS_UNIX
@@ -130,11 +129,6 @@ inline auto
 to_string(bool const& arg_) -> std::string {
     return arg_ ? "true" : "false";
 }
-
-inline auto
-to_string(regex const& arg_) -> std::string {
-    return to_string(arg_.pattern);
-}
 }  // namespace intern
 }  // namespace tpp
 
@@ -0,0 +1,206 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_TEMP_DIR_HPP
+#define TPP_TEMP_DIR_HPP
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#include "cpp_meta.hpp"
+#include "fatal.hpp"
+
+#ifdef TPP_INTERN_SYS_UNIX
+#    include <ftw.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace tpp
+{
+namespace intern
+{
+/**
+ * A directory, which is private to one run of a testcase. It is created on first use, and removed after the run,
+ * unless the testcase was unsuccessful, and directories of unsuccessful testcases shall be kept.
+ */
+class temp_dir final
+{
+public:
+    class scope final
+    {
+    public:
+        explicit scope(temp_dir* d_) : m_prev(current()) {
+            current() = d_;
+        }
+
+        ~scope() noexcept {
+            current() = m_prev;
+        }
+
+        scope(scope const&) = delete;
+        auto
+        operator=(scope const&) -> scope& = delete;
+
+    private:
+        temp_dir* m_prev;
+    };
+
+    temp_dir(char const* suite_, char const* test_) : m_suite(suite_), m_test(test_) {}
+    temp_dir(temp_dir const&) = delete;
+    auto
+    operator=(temp_dir const&) -> temp_dir& = delete;
+
+    ~temp_dir() noexcept {
+        remove();
+    }
+
+    /// Get the directory of the testcase, that runs in the current thread, or nullptr outside of testcases.
+    static auto
+    current() -> temp_dir*& {
+        static thread_local temp_dir* d{nullptr};
+        return d;
+    }
+
+    /// Whether directories of unsuccessful testcases are kept.
+    static auto
+    keep_failed() -> std::atomic<bool>& {
+        static std::atomic<bool> keep{false};
+        return keep;
+    }
+
+    /// Get the path of the directory, which is created on the first call.
+    auto
+    path() -> std::string const& {
+        if (m_path.empty()) {
+            create();
+        }
+        return m_path;
+    }
+
+    /// Check whether the directory was created.
+    inline auto
+    created() const -> bool {
+        return !m_path.empty();
+    }
+
+    /**
+     * Remove the directory after the run, unless it shall be kept.
+     * @return the path of the directory, if it was kept, else an empty string.
+     */
+    auto
+    finish(bool failed_) -> std::string {
+        std::string kept;
+        if (failed_ && keep_failed()) {
+            kept.swap(m_path);
+        } else {
+            remove();
+        }
+        return kept;
+    }
+
+private:
+    /// Get the parent directory, which is $TPP_TMP, or /dev/shm if available, to keep files in memory.
+    static auto
+    base() -> std::string {
+        auto const* env{std::getenv("TPP_TMP")};
+        if (env && *env) {
+            return env;
+        }
+#ifdef TPP_INTERN_SYS_UNIX
+        if (::access("/dev/shm", W_OK | X_OK) == 0) {
+            return "/dev/shm";
+        }
+#endif
+        return "/tmp";
+    }
+
+    /// Make a name safe for paths, by replacing unusual characters, and limiting its length.
+    static auto
+    sanitized(char const* name_) -> std::string {
+        std::string s;
+        for (auto const* c{name_}; *c && s.size() < 48; ++c) {
+            auto const ok{(*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') || (*c >= '0' && *c <= '9') ||
+                          *c == '-' || *c == '.'};
+            s.push_back(ok ? *c : '_');
+        }
+        return s;
+    }
+
+    void
+    create() {
+#ifdef TPP_INTERN_SYS_UNIX
+        static std::atomic<unsigned long> seq{0};
+        auto p{base() + "/tpp-" + std::to_string(::getpid()) + '-' + std::to_string(++seq) + '-' + sanitized(m_suite) +
+               '-' + sanitized(m_test)};
+        if (::mkdir(p.c_str(), 0700) != 0) {
+            TPP_INTERN_THROW(std::runtime_error("could not create temporary directory " + p));
+        }
+        m_path = std::move(p);
+#else
+        TPP_INTERN_THROW(std::runtime_error("temporary directories are not supported on this platform"));
+#endif
+    }
+
+#ifdef TPP_INTERN_SYS_UNIX
+    static auto
+    remove_entry(char const* path_, struct stat const*, int, struct FTW*) -> int {
+        return std::remove(path_);
+    }
+#endif
+
+    void
+    remove() noexcept {
+#ifdef TPP_INTERN_SYS_UNIX
+        if (!m_path.empty()) {
+            ::nftw(m_path.c_str(), &temp_dir::remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+            m_path.clear();
+        }
+#endif
+    }
+
+    char const* m_suite;
+    char const* m_test;
+    std::string m_path;
+};
+}  // namespace intern
+
+/**
+ * Get a directory, which is private to the current run of a testcase. It is created on the first call in a run, and
+ * placed in $TPP_TMP, or in /dev/shm if available, else in /tmp. After the run it is removed with all its content,
+ * unless the testcase was unsuccessful, and --keep-temp is given.
+ * Other threads of a testcase can use the returned path, but not call this function.
+ *
+ * EXAMPLE:
+ * @code
+ * std::ofstream out(tpp::temp_dir() + "/data.txt");
+ * @endcode
+ */
+inline auto
+temp_dir() -> std::string const& {
+    auto* d{intern::temp_dir::current()};
+    if (!d) {
+        TPP_INTERN_THROW(std::logic_error("temp_dir can only be used in testcases"));
+    }
+    return d->path();
+}
+}  // namespace tpp
+
+#endif  // TPP_TEMP_DIR_HPP
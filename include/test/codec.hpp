@@ -0,0 +1,186 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_TEST_CODEC_HPP
+#define TPP_TEST_CODEC_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "test/testcase.hpp"
+
+#include "fatal.hpp"
+
+namespace tpp
+{
+namespace intern
+{
+namespace test
+{
+/// Serialize values, and testcase results into a binary buffer. Integers are encoded in little endian byte order.
+class encoder
+{
+public:
+    auto
+    u8(std::uint8_t v_) -> encoder& {
+        m_buf.push_back(static_cast<char>(v_));
+        return *this;
+    }
+
+    auto
+    u64(std::uint64_t v_) -> encoder& {
+        for (auto i{0U}; i < 8U; ++i) {
+            m_buf.push_back(static_cast<char>((v_ >> (i * 8U)) & 0xFFU));
+        }
+        return *this;
+    }
+
+    auto
+    f64(double v_) -> encoder& {
+        std::uint64_t bits;
+        std::memcpy(&bits, &v_, sizeof(bits));
+        return u64(bits);
+    }
+
+    auto
+    str(std::string const& v_) -> encoder& {
+        u64(v_.size());
+        m_buf.append(v_);
+        return *this;
+    }
+
+    /// Encode the result of a testcase, including the records of its sections. The test function is not encoded.
+    auto
+    tc(testcase const& tc_) -> encoder& {
+        u8(static_cast<std::uint8_t>(tc_.m_result));
+        f64(tc_.m_elapsed_t);
+        str(tc_.m_err_msg);
+        str(tc_.m_cout);
+        str(tc_.m_cerr);
+        str(tc_.m_name_buf);
+        u64(tc_.m_arena_peak);
+        u64(tc_.sections().size());
+        for (auto const& s : tc_.sections()) {
+            tc(s);
+        }
+        return *this;
+    }
+
+    inline auto
+    data() -> std::string& {
+        return m_buf;
+    }
+
+private:
+    std::string m_buf;
+};
+
+/// Deserialize what was serialized by an encoder. Any malformed input leads to a runtime_error.
+class decoder
+{
+public:
+    explicit decoder(std::string const& buf_) : m_pos(buf_.data()), m_end(buf_.data() + buf_.size()) {}
+
+    auto
+    u8() -> std::uint8_t {
+        require(1);
+        return static_cast<std::uint8_t>(*m_pos++);
+    }
+
+    auto
+    u64() -> std::uint64_t {
+        require(8);
+        std::uint64_t v{0};
+        for (auto i{0U}; i < 8U; ++i) {
+            v |= static_cast<std::uint64_t>(static_cast<unsigned char>(*m_pos++)) << (i * 8U);
+        }
+        return v;
+    }
+
+    auto
+    f64() -> double {
+        auto const bits{u64()};
+        double     v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+
+    auto
+    str() -> std::string {
+        auto const len{u64()};
+        require(len);
+        std::string v(m_pos, static_cast<std::size_t>(len));
+        m_pos += len;
+        return v;
+    }
+
+    /// Most nested sections, that are decoded. Input comes from the network, so deeper nesting is malformed.
+    static constexpr unsigned MAX_DEPTH = 64;
+
+    /// Decode the result of a testcase, that belongs to the given context.
+    inline auto
+    tc(test_context const& ctx_) -> testcase {
+        return tc(ctx_, 0);
+    }
+
+    inline auto
+    done() const -> bool {
+        return m_pos == m_end;
+    }
+
+private:
+    auto
+    tc(test_context const& ctx_, unsigned depth_) -> testcase {
+        testcase   t(test_context{ctx_.tc_name, ctx_.ts_name}, nullptr);
+        auto const res{u8()};
+        if (res > testcase::HAD_ERROR || depth_ > MAX_DEPTH) {
+            TPP_INTERN_THROW(std::runtime_error("malformed testcase result"));
+        }
+        t.m_result     = static_cast<testcase::results>(res);
+        t.m_elapsed_t  = f64();
+        t.m_err_msg    = str();
+        t.m_cout       = str();
+        t.m_cerr       = str();
+        t.m_name_buf   = str();
+        t.m_arena_peak = static_cast<std::size_t>(u64());
+        auto const n{u64()};
+        if (n > 0) {
+            t.m_sections.reset(new testcase::section_state);
+            for (std::uint64_t i{0}; i < n; ++i) {
+                t.m_sections->records.push_back(tc(ctx_, depth_ + 1));
+            }
+        }
+        return t;
+    }
+
+    void
+    require(std::uint64_t n_) const {
+        if (static_cast<std::uint64_t>(m_end - m_pos) < n_) {
+            TPP_INTERN_THROW(std::runtime_error("malformed message, unexpected end of data"));
+        }
+    }
+
+    char const*       m_pos;
+    char const* const m_end;
+};
+}  // namespace test
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_TEST_CODEC_HPP
@@ -0,0 +1,300 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_TEST_DATASET_HPP
+#define TPP_TEST_DATASET_HPP
+
+#include <cctype>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "cpp_meta.hpp"
+#include "fatal.hpp"
+
+#ifdef TPP_INTERN_SYS_LINUX
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace tpp
+{
+namespace intern
+{
+namespace test
+{
+/**
+ * Create the directory dir_, if it does not exist. Returns false, if it is not a directory, that is private to the
+ * user. That is, it must not be a symlink, must be owned by the user, and only be accessible by them.
+ */
+inline auto
+private_dir(std::string const& dir_) -> bool {
+#ifdef TPP_INTERN_SYS_LINUX
+    ::mkdir(dir_.c_str(), 0700);
+    struct stat st
+    {};
+    return ::lstat(dir_.c_str(), &st) == 0 && S_ISDIR(st.st_mode) && st.st_uid == ::getuid() &&
+           (st.st_mode & 0777) == 0700;
+#else
+    static_cast<void>(dir_);
+    return false;
+#endif
+}
+
+/**
+ * Get the path of the cache file for the dataset key_. Cache files are kept in $TPP_CACHE, or a directory private to
+ * the user in /tmp. An empty path is returned, if datasets can not be cached on this system, or the directory in /tmp
+ * is not private, because another user could control the cached datasets then.
+ */
+inline auto
+dataset_file(std::string const& key_) -> std::string {
+#ifdef TPP_INTERN_SYS_LINUX
+    auto const* env{std::getenv("TPP_CACHE")};
+    auto const  dir{env && *env ? std::string(env) : "/tmp/tpp-cache-" + std::to_string(::getuid())};
+    if (env && *env) {
+        ::mkdir(dir.c_str(), 0700);
+    } else if (!private_dir(dir)) {
+        return std::string();
+    }
+    std::string name;
+    for (auto c : key_) {
+        name += std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '.' ? c : '_';
+    }
+    return dir + '/' + name + ".tppdata";
+#else
+    static_cast<void>(key_);
+    return std::string();
+#endif
+}
+
+/**
+ * A read-only array of trivially copyable elements, which is generated once, and cached in a file.
+ * On later runs the cache file is memory-mapped instead, as long as its version, and element type match.
+ * The cache file starts with a header of 64 bytes, followed by the raw elements.
+ */
+template<typename T>
+class dataset final
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Elements of a dataset must be trivially copyable!");
+
+public:
+    dataset(dataset const&) = delete;
+    auto
+    operator=(dataset const&) -> dataset& = delete;
+
+    ~dataset() noexcept {
+#ifdef TPP_INTERN_SYS_LINUX
+        if (m_map) {
+            ::munmap(m_map, m_map_len);
+        }
+#endif
+    }
+
+    /**
+     * Map the cache file at path_, or if it is missing, outdated, or corrupt, generate the elements by make_, which
+     * returns a vector of them, and write them to the cache file. Without cache support the elements are only kept
+     * in memory.
+     */
+    template<typename Fn>
+    static auto
+    load(std::string const& path_, std::string const& version_, Fn&& make_) -> std::unique_ptr<dataset> {
+        std::unique_ptr<dataset> d(new dataset);
+        auto const               hdr{header(version_)};
+        if (!path_.empty() && d->map(path_, hdr)) {
+            return d;
+        }
+        d->m_owned = make_();
+        d->m_data  = d->m_owned.data();
+        d->m_size  = d->m_owned.size();
+        if (!path_.empty()) {
+            store(path_, hdr, d->m_owned);
+        }
+        return d;
+    }
+
+    inline auto
+    data() const -> T const* {
+        return m_data;
+    }
+
+    inline auto
+    size() const -> std::size_t {
+        return m_size;
+    }
+
+    inline auto
+    empty() const -> bool {
+        return m_size == 0;
+    }
+
+    inline auto
+    begin() const -> T const* {
+        return m_data;
+    }
+
+    inline auto
+    end() const -> T const* {
+        return m_data + m_size;
+    }
+
+    inline auto
+    operator[](std::size_t i_) const -> T const& {
+        return m_data[i_];
+    }
+
+    /// Check whether the elements are mapped from the cache file.
+    inline auto
+    mapped() const -> bool {
+        return m_map != nullptr;
+    }
+
+private:
+    static constexpr std::size_t HEADER_SIZE = 64;
+
+    struct file_header
+    {
+        char          magic[8];
+        std::uint64_t version;  ///< Hash of the version, and the signature of T.
+        std::uint64_t elem_size;
+        std::uint64_t count;
+        char          reserved[32];
+    };
+
+    dataset() = default;
+
+    static auto
+    header(std::string const& version_) -> file_header {
+        file_header hdr{};
+        std::memcpy(hdr.magic, "TPPDATA1", sizeof(hdr.magic));
+        auto const sig{version_ + '\0' + typeid(T).name() + '\0' + std::to_string(alignof(T))};
+        hdr.version = 0xcbf29ce484222325ULL;
+        for (auto c : sig) {
+            hdr.version = (hdr.version ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+        }
+        hdr.elem_size = sizeof(T);
+        return hdr;
+    }
+
+    /// Check whether the file size matches the header exactly. A corrupt count must not overflow the expected size.
+    static inline auto
+    fits(std::uint64_t size_, file_header const& hdr_) -> bool {
+        return size_ >= HEADER_SIZE && hdr_.count <= (size_ - HEADER_SIZE) / hdr_.elem_size &&
+               size_ - HEADER_SIZE == hdr_.count * hdr_.elem_size;
+    }
+
+    auto
+    map(std::string const& path_, file_header const& expected_) -> bool {
+#ifdef TPP_INTERN_SYS_LINUX
+        auto const fd{::open(path_.c_str(), O_RDONLY | O_CLOEXEC)};
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st
+        {};
+        file_header hdr{};
+        auto const  ok{::fstat(fd, &st) == 0 && ::read(fd, &hdr, sizeof(hdr)) == static_cast<ssize_t>(sizeof(hdr)) &&
+                      std::memcmp(hdr.magic, expected_.magic, sizeof(hdr.magic)) == 0 &&
+                      hdr.version == expected_.version && hdr.elem_size == expected_.elem_size &&
+                      fits(static_cast<std::uint64_t>(st.st_size), hdr)};
+        void* const m{ok ? ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0)
+                         : MAP_FAILED};
+        ::close(fd);
+        if (m == MAP_FAILED) {
+            return false;
+        }
+        m_map     = m;
+        m_map_len = static_cast<std::size_t>(st.st_size);
+        m_data    = reinterpret_cast<T const*>(static_cast<char const*>(m) + HEADER_SIZE);
+        m_size    = static_cast<std::size_t>(hdr.count);
+        return true;
+#else
+        static_cast<void>(path_);
+        static_cast<void>(expected_);
+        return false;
+#endif
+    }
+
+    /// Write the cache file, which is replaced atomically, so that concurrent runs never see a partial file.
+    static void
+    store(std::string const& path_, file_header hdr_, std::vector<T> const& elems_) {
+#ifdef TPP_INTERN_SYS_LINUX
+        hdr_.count = elems_.size();
+        auto const tmp{path_ + ".tmp." + std::to_string(::getpid())};
+        auto const fd{::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC, 0600)};
+        if (fd < 0) {
+            TPP_INTERN_THROW(std::runtime_error("could not write dataset cache " + path_));
+        }
+        bool const written{write_all(fd, reinterpret_cast<char const*>(&hdr_), sizeof(hdr_)) &&
+                           write_all(fd, reinterpret_cast<char const*>(elems_.data()), elems_.size() * sizeof(T))};
+        if (::close(fd) != 0 || !written) {
+            std::remove(tmp.c_str());
+            TPP_INTERN_THROW(std::runtime_error("could not write dataset cache " + path_));
+        }
+        if (std::rename(tmp.c_str(), path_.c_str()) != 0) {
+            std::remove(tmp.c_str());
+            TPP_INTERN_THROW(std::runtime_error("could not write dataset cache " + path_));
+        }
+#else
+        static_cast<void>(path_);
+        static_cast<void>(hdr_);
+        static_cast<void>(elems_);
+#endif
+    }
+
+#ifdef TPP_INTERN_SYS_LINUX
+    static auto
+    write_all(int fd_, char const* buf_, std::size_t len_) -> bool {
+        while (len_ > 0) {
+            auto const n{::write(fd_, buf_, len_)};
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            buf_ += n;
+            len_ -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+#endif
+
+    std::vector<T> m_owned;
+    void*          m_map{nullptr};
+    std::size_t    m_map_len{0};
+    T const*       m_data{nullptr};
+    std::size_t    m_size{0};
+
+    static_assert(sizeof(file_header) == HEADER_SIZE, "The header of a dataset cache file must be 64 bytes!");
+};
+}  // namespace test
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_TEST_DATASET_HPP
@@ -0,0 +1,214 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_TEST_FIXTURE_POOL_HPP
+#define TPP_TEST_FIXTURE_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "duration.hpp"
+
+namespace tpp
+{
+namespace intern
+{
+namespace test
+{
+/// Statistics of a fixture pool.
+struct pool_statistic
+{
+    std::size_t checkouts{0};  ///< Number of times an instance was checked out.
+    std::size_t created{0};    ///< Number of instances, that were constructed.
+    std::size_t reuses{0};     ///< Number of checkouts, that got an instance used before.
+    std::size_t waits{0};      ///< Number of checkouts, that had to wait for an instance to be returned.
+    double      wait_t{0.0};   ///< Total time spent waiting for instances in milliseconds.
+    double      max_wait_t{0.0};
+};
+
+/**
+ * A pool of at most a fixed number of fixtures, which are checked out by testcases for exclusive use, and returned
+ * afterwards. Instances are default constructed on demand, so that no more of them exist than are used concurrently.
+ * A reset hook is run on an instance before it is handed out again. A testcase must not check out more instances at
+ * once, than the pool holds, as it would wait forever.
+ */
+template<typename T>
+class fixture_pool final
+{
+public:
+    using reset_function = std::function<void(T&)>;
+
+    /// Exclusive use of an instance, which is returned to the pool on destruction.
+    class lease final
+    {
+    public:
+        lease(lease&& other_) noexcept : m_pool(other_.m_pool), m_obj(other_.m_obj) {
+            other_.m_pool = nullptr;
+        }
+
+        lease(lease const&) = delete;
+        auto
+        operator=(lease const&) -> lease& = delete;
+        auto
+        operator=(lease&&) noexcept -> lease& = delete;
+
+        ~lease() noexcept {
+            if (m_pool) {
+                m_pool->give_back(m_obj);
+            }
+        }
+
+        inline auto
+        get() const -> T& {
+            return *m_obj;
+        }
+
+        inline auto
+        operator*() const -> T& {
+            return *m_obj;
+        }
+
+        inline auto
+        operator->() const -> T* {
+            return m_obj;
+        }
+
+    private:
+        friend class fixture_pool;
+
+        lease(fixture_pool* pool_, T* obj_) : m_pool(pool_), m_obj(obj_) {}
+
+        fixture_pool* m_pool;
+        T*            m_obj;
+    };
+
+    explicit fixture_pool(std::size_t size_) : m_size(size_ > 0 ? size_ : 1) {}
+
+    fixture_pool(fixture_pool const&) = delete;
+    auto
+    operator=(fixture_pool const&) -> fixture_pool& = delete;
+
+    /// Set the hook, that resets an instance in between two uses.
+    void
+    on_reset(reset_function&& fn_) {
+        std::lock_guard<std::mutex> lk(m_mtx);
+        m_reset = std::move(fn_);
+    }
+
+    /// Check out an instance, and wait until one is returned, if all of them are in use.
+    auto
+    checkout() -> lease {
+        std::unique_lock<std::mutex> lk(m_mtx);
+        ++m_stats.checkouts;
+        if (m_free.empty() && m_count >= m_size) {
+            duration d;
+            m_cv.wait(lk, [this] { return !m_free.empty() || m_count < m_size; });
+            auto const t{d.get()};
+            ++m_stats.waits;
+            m_stats.wait_t += t;
+            m_stats.max_wait_t = std::max(m_stats.max_wait_t, t);
+        }
+        if (m_free.empty()) {
+            ++m_count;
+            lk.unlock();
+            return lease(this, create());
+        }
+        auto* const obj{m_free.back()};
+        m_free.pop_back();
+        ++m_stats.reuses;
+        auto const reset{m_reset};
+        lk.unlock();
+        if (reset) {
+            lease l(this, obj);
+            reset(*obj);
+            l.m_pool = nullptr;
+        }
+        return lease(this, obj);
+    }
+
+    auto
+    statistics() const -> pool_statistic {
+        std::lock_guard<std::mutex> lk(m_mtx);
+        return m_stats;
+    }
+
+    inline auto
+    size() const -> std::size_t {
+        return m_size;
+    }
+
+private:
+    /// A slot for an instance in construction, which is given up, unless it is taken.
+    struct slot final
+    {
+        explicit slot(fixture_pool* pool_) : pool(pool_) {}
+
+        ~slot() noexcept {
+            if (!taken) {
+                {
+                    std::lock_guard<std::mutex> lk(pool->m_mtx);
+                    --pool->m_count;
+                }
+                pool->m_cv.notify_one();
+            }
+        }
+
+        fixture_pool* pool;
+        bool          taken{false};
+    };
+
+    /// Construct a new instance outside of the lock, as fixtures in a pool are usually expensive to construct.
+    auto
+    create() -> T* {
+        slot                        s(this);
+        std::unique_ptr<T>          obj(new T());
+        std::lock_guard<std::mutex> lk(m_mtx);
+        m_all.push_back(std::move(obj));
+        ++m_stats.created;
+        s.taken = true;
+        return m_all.back().get();
+    }
+
+    void
+    give_back(T* obj_) noexcept {
+        {
+            std::lock_guard<std::mutex> lk(m_mtx);
+            m_free.push_back(obj_);
+        }
+        m_cv.notify_one();
+    }
+
+    std::size_t const               m_size;
+    std::size_t                     m_count{0};  ///< Number of instances, that exist or are in construction.
+    mutable std::mutex              m_mtx;
+    std::condition_variable         m_cv;
+    std::vector<std::unique_ptr<T>> m_all;
+    std::vector<T*>                 m_free;
+    reset_function                  m_reset;
+    pool_statistic                  m_stats;
+};
+}  // namespace test
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_TEST_FIXTURE_POOL_HPP
@@ -0,0 +1,127 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_TEST_FIXTURE_STORE_HPP
+#define TPP_TEST_FIXTURE_STORE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+
+#include "fatal.hpp"
+
+namespace tpp
+{
+namespace intern
+{
+namespace test
+{
+/**
+ * Owns global fixtures, which are constructed on first use, and live as long as the store.
+ * Fixtures are identified by their name, and the signature of their type, which is its name, size, and alignment.
+ * Hence a fixture is found again by code of a reloaded module, as long as its signature did not change.
+ * Fixtures, that are declared by testsuites, are counted, and destroyed when the last of them released it.
+ * Each fixture is constructed under its own lock, so that a slow construction blocks only users of that fixture.
+ */
+class fixture_store
+{
+public:
+    /// Get the fixture name_ of type T. It is constructed by make_, which returns a unique, or shared pointer to it.
+    template<typename T, typename Fn>
+    auto
+    obtain(char const* name_, Fn&& make_) -> T& {
+        std::shared_ptr<slot> s;
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            auto&                       e{m_fixtures[signature<T>(name_)]};
+            if (!e) {
+                e = std::make_shared<slot>();
+            }
+            s = e;
+        }
+        std::lock_guard<std::mutex> lk(s->mutex);
+        if (!s->fixture) {
+            std::shared_ptr<T> p(make_());
+            if (!p) {
+                TPP_INTERN_THROW(std::runtime_error(std::string("could not construct fixture ") + name_));
+            }
+            s->fixture = std::move(p);
+        }
+        return *static_cast<T*>(s->fixture.get());
+    }
+
+    /// Add a user to the fixture with signature key_. It is constructed lazily by obtain, once it is used.
+    void
+    acquire(std::string const& key_) {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        ++m_users[key_];
+    }
+
+    /// Remove a user from the fixture with signature key_, which is destroyed after the last user released it.
+    void
+    release(std::string const& key_) {
+        std::shared_ptr<slot> f;
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            auto const                  it{m_users.find(key_)};
+            if (it == m_users.end() || --it->second > 0) {
+                return;
+            }
+            m_users.erase(it);
+            auto const fit{m_fixtures.find(key_)};
+            if (fit != m_fixtures.end()) {
+                f = std::move(fit->second);
+                m_fixtures.erase(fit);
+            }
+        }
+    }
+
+    template<typename T>
+    static auto
+    signature(char const* name_) -> std::string {
+        return std::string(name_) + '\0' + typeid(T).name() + '\0' + std::to_string(sizeof(T)) + '/' +
+               std::to_string(alignof(T));
+    }
+
+    auto
+    size() const -> std::size_t {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        return m_fixtures.size();
+    }
+
+private:
+    /// A fixture, which is constructed at most once.
+    struct slot final
+    {
+        std::mutex            mutex;  ///< Held while the fixture is constructed.
+        std::shared_ptr<void> fixture;
+    };
+
+    mutable std::mutex                                     m_mutex;  ///< Guards only the maps, not construction.
+    std::unordered_map<std::string, std::shared_ptr<slot>> m_fixtures;
+    std::unordered_map<std::string, std::size_t>           m_users;
+};
+}  // namespace test
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_TEST_FIXTURE_STORE_HPP
@@ -0,0 +1,178 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_TEST_GENERATOR_HPP
+#define TPP_TEST_GENERATOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "test/run_config.hpp"
+#include "test/testcase.hpp"
+
+namespace tpp
+{
+namespace intern
+{
+namespace test
+{
+using generator_function = std::function<void(std::size_t)>;
+
+/**
+ * A generator produces a number of testcases on demand, instead of holding them all at once.
+ * Only the results that are kept according to the generator_policy consume memory.
+ */
+class generator
+{
+public:
+    generator(generator const&) = delete;
+    generator(generator&&)      = default;
+    ~generator() noexcept       = default;
+    auto
+    operator=(generator const&) -> generator& = delete;
+    auto
+    operator=(generator&&) -> generator& = default;
+
+    generator(test_context&& ctx_, std::size_t count_, generator_function&& fn_)
+        : m_name(ctx_.tc_name), m_suite_name(ctx_.ts_name), m_count(count_), m_gen_fn(std::move(fn_)) {}
+
+    /// Make the testcase for the case at index idx_. It lives only as long as it is needed.
+    auto
+    make_testcase(std::size_t idx_) const -> testcase {
+        generator_function const* fn{&m_gen_fn};
+        return testcase(test_context{m_name, m_suite_name}, [fn, idx_] {
+            random::source::case_index() = idx_ + 1;
+            (*fn)(idx_);
+        });
+    }
+
+    /// Record the result of a generated case. This is not threadsafe.
+    void
+    record(std::size_t idx_, testcase&& tc_, generator_policy pol_) {
+        m_elapsed_t += tc_.elapsed_time();
+        switch (tc_.result()) {
+            case testcase::HAS_FAILED: ++m_num_fails; break;
+            case testcase::HAD_ERROR: ++m_num_errs; break;
+            default:
+                if (pol_ != generator_policy::ALL) {
+                    return;
+                }
+                break;
+        }
+        if (tc_.result() != testcase::HAS_PASSED && idx_ < m_first_fault) {
+            m_first_fault = idx_;
+            m_first_reason.assign(tc_.reason());
+        }
+        if (pol_ != generator_policy::AGGREGATE) {
+            tc_.rename(case_name(idx_));
+            tc_.m_test_fn = nullptr;
+            m_results.emplace_back(idx_, std::move(tc_));
+        }
+    }
+
+    /// Record the elapsed time of passed cases, that were run elsewhere and are not kept.
+    void
+    record_passed(double elapsed_t_) {
+        m_elapsed_t += elapsed_t_;
+    }
+
+    /**
+     * Finish this generator and take all kept results, ordered by index. With the aggregate policy a summary of all
+     * cases is appended. With the failed policy it is appended only if all cases passed, so that the generator is
+     * still listed, while each unsuccessful case is reported just once.
+     */
+    auto
+    finish(generator_policy pol_) -> std::vector<testcase> {
+        std::vector<testcase> res;
+        std::sort(m_results.begin(), m_results.end(),
+                  [](indexed_result const& l_, indexed_result const& r_) { return l_.first < r_.first; });
+        res.reserve(m_results.size() + 1);
+        std::for_each(m_results.begin(), m_results.end(),
+                      [&](indexed_result& r_) { res.push_back(std::move(r_.second)); });
+        auto const passed{m_num_errs + m_num_fails == 0};
+        if (pol_ == generator_policy::AGGREGATE || (pol_ == generator_policy::FAILED && passed)) {
+            res.push_back(summary());
+        }
+        m_results.clear();
+        m_results.shrink_to_fit();
+        m_done = true;
+        return res;
+    }
+
+    inline auto
+    size() const -> std::size_t {
+        return m_count;
+    }
+
+    inline auto
+    done() const -> bool {
+        return m_done;
+    }
+
+    inline auto
+    name() const -> char const* {
+        return m_name;
+    }
+
+private:
+    using indexed_result = std::pair<std::size_t, testcase>;
+
+    auto
+    case_name(std::size_t idx_) const -> std::string {
+        return std::string(m_name) + " #" + std::to_string(idx_);
+    }
+
+    auto
+    summary() const -> testcase {
+        testcase tc(test_context{m_name, m_suite_name}, nullptr);
+        tc.m_elapsed_t = m_elapsed_t;
+        if (m_num_errs + m_num_fails == 0) {
+            tc.pass();
+            return tc;
+        }
+        auto const reason{std::to_string(m_num_fails) + " of " + std::to_string(m_count) + " cases failed, " +
+                          std::to_string(m_num_errs) + " erroneous; first at #" + std::to_string(m_first_fault) +
+                          ": " + m_first_reason};
+        if (m_num_errs > 0) {
+            tc.error(reason.c_str());
+        } else {
+            tc.fail(reason.c_str());
+        }
+        return tc;
+    }
+
+    char const*                 m_name;
+    char const*                 m_suite_name;
+    std::size_t                 m_count;
+    bool                        m_done{false};
+    std::size_t                 m_num_fails{0};
+    std::size_t                 m_num_errs{0};
+    double                      m_elapsed_t{.0};
+    std::size_t                 m_first_fault{static_cast<std::size_t>(-1)};
+    std::string                 m_first_reason;
+    std::vector<indexed_result> m_results;
+    generator_function          m_gen_fn;
+};
+}  // namespace test
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_TEST_GENERATOR_HPP
@@ -0,0 +1,93 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_TEST_QUARANTINE_HPP
+#define TPP_TEST_QUARANTINE_HPP
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tpp
+{
+namespace intern
+{
+namespace test
+{
+class quarantine;
+using quarantine_ptr = std::shared_ptr<quarantine const>;
+
+/**
+ * A list of testcases, whose failures do not count for the exit code. Each entry is a pattern for the name of a
+ * testsuite and the declared name of a testcase, separated by a slash, where * matches any sequence of characters.
+ * The declared name covers all sections of a testcase, and all cases of a generator.
+ */
+class quarantine final
+{
+public:
+    void
+    add(std::string&& pattern_) {
+        m_patterns.push_back(std::move(pattern_));
+    }
+
+    auto
+    contains(char const* suite_, char const* test_) const -> bool {
+        if (m_patterns.empty()) {
+            return false;
+        }
+        auto const name{std::string(suite_) + '/' + test_};
+        for (auto const& p : m_patterns) {
+            if (match(p.c_str(), name.c_str())) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static auto
+    match(char const* p_, char const* s_) -> bool {
+        char const* star{nullptr};
+        char const* resume{nullptr};
+        while (*s_) {
+            if (*p_ == '*') {
+                star   = p_++;
+                resume = s_;
+            } else if (*p_ == *s_) {
+                ++p_;
+                ++s_;
+            } else if (star) {
+                p_ = star + 1;
+                s_ = ++resume;
+            } else {
+                return false;
+            }
+        }
+        while (*p_ == '*') {
+            ++p_;
+        }
+        return *p_ == '\0';
+    }
+
+    std::vector<std::string> m_patterns;
+};
+}  // namespace test
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_TEST_QUARANTINE_HPP
@@ -0,0 +1,49 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_TEST_RUN_CONFIG_HPP
+#define TPP_TEST_RUN_CONFIG_HPP
+
+#include <cstddef>
+
+#include "listener.hpp"
+
+namespace tpp
+{
+namespace intern
+{
+namespace test
+{
+/// Defines which results of generated testcases are kept for reporting.
+enum class generator_policy
+{
+    ALL,       ///< Keep a result for every generated case.
+    FAILED,    ///< Keep results of unsuccessful cases, or a summary, if all cases passed.
+    AGGREGATE  ///< Keep only a summary.
+};
+
+struct run_config
+{
+    generator_policy gen_policy{generator_policy::FAILED};
+    std::size_t      retries{0};  ///< How often unsuccessful testcases are rerun.
+    listener_list*   listeners{nullptr};  ///< Notified of each finished testcase, if set.
+};
+}  // namespace test
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_TEST_RUN_CONFIG_HPP
@@ -0,0 +1,212 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_TEST_SECTION_HPP
+#define TPP_TEST_SECTION_HPP
+
+#include <exception>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assert/assertion_failure.hpp"
+
+#include "cpp_meta.hpp"
+
+namespace tpp
+{
+namespace intern
+{
+namespace test
+{
+/// Names of nested sections, from the outermost to the innermost.
+using section_path = std::vector<std::string>;
+
+/**
+ * Decides which sections are entered during a single execution of a testcase.
+ * All sections on the way to the target path are entered, afterwards the first section on each level is entered,
+ * until a leaf section is left. Every section that is not entered is recorded as discovered.
+ * When resuming after a leaf that failed, the known sections below the target path are skipped instead, so that the
+ * first section after them is entered, which was never reached before.
+ */
+class section_tracker
+{
+public:
+    section_tracker(section_tracker const&)     = delete;
+    section_tracker(section_tracker&&) noexcept = delete;
+    ~section_tracker() noexcept                 = default;
+    auto
+    operator=(section_tracker const&) -> section_tracker& = delete;
+    auto
+    operator=(section_tracker&&) noexcept -> section_tracker& = delete;
+
+    /**
+     * @param target_ is the path to run.
+     * @param known_ are the known sections, which are skipped below target_. If null, target_ itself is run.
+     */
+    explicit section_tracker(section_path const& target_, std::set<section_path> const* known_ = nullptr)
+        : m_target(target_), m_known(known_) {}
+
+    auto
+    enter(char const* name_) -> bool {
+        m_used = true;
+        section_path path(m_stack);
+        path.emplace_back(name_);
+        if (!m_leaf_done) {
+            if (m_stack.size() >= m_target.size()) {
+                if (!m_known || m_known->count(path) == 0) {
+                    m_stack = std::move(path);
+                    return true;
+                }
+                return false;
+            }
+            if (m_target[m_stack.size()] == name_) {
+                m_stack = std::move(path);
+                return true;
+            }
+        }
+        m_discovered.push_back(std::move(path));
+        return false;
+    }
+
+    void
+    leave() {
+        if (!m_leaf_done && (!m_known || m_stack.size() > m_target.size())) {
+            m_leaf_done = true;
+            m_aborted   = m_stack.size() > m_target.size() && unwinding();
+            m_leaf      = m_stack;
+        }
+        m_stack.pop_back();
+    }
+
+    inline auto
+    used() const -> bool {
+        return m_used;
+    }
+
+    /// Check whether a leaf section was run. When resuming, there may be no section left to run.
+    inline auto
+    has_leaf() const -> bool {
+        return m_leaf_done;
+    }
+
+    /**
+     * Check whether the leaf section was left by a failure, hence the sections after it were never reached. Sections
+     * beside the target path are not affected, as they were discovered by the run, which discovered the target.
+     */
+    inline auto
+    aborted() const -> bool {
+        return m_aborted;
+    }
+
+    /// Get the path of the leaf section that was run, or the target if it was never reached.
+    auto
+    leaf() -> section_path&& {
+        return std::move(m_leaf_done ? m_leaf : m_target);
+    }
+
+    auto
+    discovered() -> std::vector<section_path>&& {
+        return std::move(m_discovered);
+    }
+
+    /// Install a tracker for the current thread, as long as this scope lives.
+    class scope
+    {
+    public:
+        scope(scope const&)     = delete;
+        scope(scope&&) noexcept = delete;
+        auto
+        operator=(scope const&) -> scope& = delete;
+        auto
+        operator=(scope&&) noexcept -> scope& = delete;
+
+        explicit scope(section_tracker* t_) : m_prev(current()) {
+            current() = t_;
+        }
+
+        ~scope() noexcept {
+            current() = m_prev;
+        }
+
+    private:
+        section_tracker* m_prev;
+    };
+
+    static auto
+    current() -> section_tracker*& {
+        static thread_local section_tracker* t{nullptr};
+        return t;
+    }
+
+private:
+    /// Check whether the testcase body is left, because an assertion failed, or an exception was thrown.
+    static auto
+    unwinding() -> bool {
+#if defined(TPP_INTERN_NO_EXCEPTIONS)
+        return assert::current_failure().failed;
+#elif defined(TPP_INTERN_CPP_V17)
+        return std::uncaught_exceptions() > 0;
+#else
+        return std::uncaught_exception();
+#endif
+    }
+
+    section_path                  m_target;
+    std::set<section_path> const* m_known;
+    section_path                  m_stack;
+    section_path                  m_leaf;
+    std::vector<section_path>     m_discovered;
+    bool                          m_leaf_done{false};
+    bool                          m_aborted{false};
+    bool                          m_used{false};
+};
+
+/// A section is entered, if its condition holds. Outside of a testcase every section is entered.
+class section final
+{
+public:
+    section(section const&)     = delete;
+    section(section&&) noexcept = delete;
+    auto
+    operator=(section const&) -> section& = delete;
+    auto
+    operator=(section&&) noexcept -> section& = delete;
+
+    explicit section(char const* name_)
+        : m_tracker(section_tracker::current()), m_entered(!m_tracker || m_tracker->enter(name_)) {}
+
+    ~section() noexcept {
+        if (m_tracker && m_entered) {
+            m_tracker->leave();
+        }
+    }
+
+    explicit operator bool() const noexcept {
+        return m_entered;
+    }
+
+private:
+    section_tracker* const m_tracker;
+    bool const             m_entered;
+};
+}  // namespace test
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_TEST_SECTION_HPP
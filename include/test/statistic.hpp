@@ -49,6 +49,18 @@ public:
         return m_num_errs;
     }
 
+    /// Get the number of testcases, that passed only on a retry.
+    inline auto
+    flaky() const -> std::size_t {
+        return m_num_flaky;
+    }
+
+    /// Get the number of failures and errors of quarantined testcases.
+    inline auto
+    quarantined() const -> std::size_t {
+        return m_num_quarantined;
+    }
+
     inline auto
     elapsed_time() const -> double {
         return m_elapsed_t;
@@ -61,6 +73,8 @@ private:
     std::size_t m_num_tests{0};
     std::size_t m_num_fails{0};
     std::size_t m_num_errs{0};
+    std::size_t m_num_flaky{0};
+    std::size_t m_num_quarantined{0};
     double      m_elapsed_t{.0};
 };
 }  // namespace test
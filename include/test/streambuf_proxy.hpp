@@ -24,6 +24,7 @@
 #include <ostream>
 #include <sstream>
 #include <streambuf>
+#include <string>
 #include <vector>
 
 #ifdef _OPENMP
@@ -39,6 +40,27 @@ namespace intern
 {
 namespace test
 {
+/// A string buffer, that can tell whether anything was written to it, without copying its content.
+class capture_buffer : public std::stringbuf
+{
+public:
+    inline auto
+    empty() const -> bool {
+        return pptr() == pbase();
+    }
+
+    /// Move the content into str_, and clear this buffer.
+    void
+    take(std::string& str_) {
+        if (empty()) {
+            str_.clear();
+            return;
+        }
+        str_ = str();
+        str("");
+    }
+};
+
 class streambuf_proxy : public std::streambuf
 {
 public:
@@ -56,44 +78,24 @@ public:
         m_orig_stream.rdbuf(m_orig_buf);
     }
 
-    virtual auto
-    str() -> std::string = 0;
+    /// Move the output captured in the current thread into str_. Nothing is copied, if there was no output.
+    virtual void
+    take(std::string& str_) = 0;
 
 protected:
-    template<typename T>
-    class clearer
-    {
-        T* m_buf;
-
-    public:
-        clearer(clearer const&)     = delete;
-        clearer(clearer&&) noexcept = delete;
-        auto
-        operator=(clearer const&) -> clearer& = delete;
-        auto
-        operator=(clearer&&) noexcept -> clearer& = delete;
-
-        explicit clearer(T* b_) : m_buf(b_) {}
-
-        ~clearer() noexcept {
-            m_buf->str("");
-        }
-    };
-
     std::streambuf* m_orig_buf;
     std::ostream&   m_orig_stream;
 };
 
-class streambuf_proxy_single : public streambuf_proxy
+class streambuf_proxy_single final : public streambuf_proxy
 {
 public:
     explicit streambuf_proxy_single(std::ostream& stream_) : streambuf_proxy(stream_) {}
 
-    auto
-    str() -> std::string override {
-        clearer<std::stringbuf> _(&m_buffer);
+    void
+    take(std::string& str_) override {
         m_orig_stream.flush();
-        return m_buffer.str();
+        m_buffer.take(str_);
     }
 
 private:
@@ -109,11 +111,11 @@ private:
         return m_buffer.sputn(s_, n_);
     }
 
-    std::stringbuf m_buffer;
+    capture_buffer m_buffer;
     std::mutex mutable m_mutex;
 };
 
-class streambuf_proxy_omp : public streambuf_proxy
+class streambuf_proxy_omp final : public streambuf_proxy
 {
 #define TPP_INTERN_CURRENT_THREAD_BUFFER() (m_thd_buffers[static_cast<std::size_t>(omp_get_thread_num())])
 
@@ -121,11 +123,9 @@ public:
     explicit streambuf_proxy_omp(std::ostream& stream_)
         : streambuf_proxy(stream_), m_thd_buffers(static_cast<std::size_t>(omp_get_max_threads())) {}
 
-    auto
-    str() -> std::string override {
-        auto&                   buf = TPP_INTERN_CURRENT_THREAD_BUFFER();
-        clearer<std::stringbuf> _(&buf);
-        return buf.str();
+    void
+    take(std::string& str_) override {
+        TPP_INTERN_CURRENT_THREAD_BUFFER().take(str_);
     }
 
 private:
@@ -139,7 +139,7 @@ private:
         return TPP_INTERN_CURRENT_THREAD_BUFFER().sputn(s_, n_);
     }
 
-    std::vector<std::stringbuf> m_thd_buffers;
+    std::vector<capture_buffer> m_thd_buffers;
 
 #undef TPP_INTERN_CURRENT_THREAD_BUFFER
 };
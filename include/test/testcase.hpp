@@ -18,13 +18,25 @@
 #ifndef TPP_TEST_TESTCASE_HPP
 #define TPP_TEST_TESTCASE_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <deque>
 #include <functional>
+#include <memory>
+#include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "assert/assertion_failure.hpp"
+#include "test/section.hpp"
 
+#include "arena.hpp"
+#include "clock.hpp"
 #include "duration.hpp"
+#include "fatal.hpp"
+#include "random.hpp"
+#include "temp_dir.hpp"
 
 namespace tpp
 {
@@ -34,6 +46,11 @@ namespace test
 {
 using test_function = std::function<void()>;
 
+class generator;
+class testsuite;
+class encoder;
+class decoder;
+
 struct test_context final
 {
     char const* const tc_name;
@@ -44,7 +61,7 @@ class testcase
 {
 public:
     testcase(testcase const&) = delete;
-    ~testcase() noexcept      = default;
+    ~testcase() noexcept;
     auto
     operator=(testcase const&) -> testcase& = delete;
 
@@ -57,18 +74,17 @@ public:
           m_result(other_.m_result),
           m_elapsed_t(other_.m_elapsed_t),
           m_err_msg(std::move(other_.m_err_msg)),
-          m_test_fn(std::move(other_.m_test_fn)) {}
+          m_cout(std::move(other_.m_cout)),
+          m_cerr(std::move(other_.m_cerr)),
+          m_name_buf(std::move(other_.m_name_buf)),
+          m_test_fn(std::move(other_.m_test_fn)),
+          m_sections(std::move(other_.m_sections)),
+          m_attempts(std::move(other_.m_attempts)),
+          m_quarantined(other_.m_quarantined),
+          m_arena_peak(other_.m_arena_peak) {}
 
     auto
-    operator=(testcase&& other_) noexcept -> testcase& {
-        m_name       = other_.m_name;
-        m_suite_name = other_.m_suite_name;
-        m_result     = other_.m_result;
-        m_elapsed_t  = other_.m_elapsed_t;
-        m_err_msg    = std::move(other_.m_err_msg);
-        m_test_fn    = std::move(other_.m_test_fn);
-        return *this;
-    }
+    operator=(testcase&& other_) noexcept -> testcase&;
 
     enum results
     {
@@ -78,24 +94,47 @@ public:
         HAD_ERROR
     };
 
+    /// The outcome of a previous, unsuccessful run of a testcase, that was retried.
+    struct attempt
+    {
+        results     result;
+        double      elapsed_t;
+        std::string reason;
+    };
+
     void
-    operator()() {
-        if (m_result != IS_UNDONE) {
-            return;
-        }
-        class duration dur;
-        try {
-            m_test_fn();
-            pass();
-        } catch (assert::assertion_failure const& e) {
-            fail(e.what());
-        } catch (std::exception const& e) {
-            error(e.what());
-        } catch (...) {
-            error();
-        }
-        m_elapsed_t = dur.get();
-    }
+    operator()();
+
+    /// Run this testcase as lap of laps_, so that consecutive testcases read the clock only once each.
+    void
+    operator()(lap_timer& laps_);
+
+    /**
+     * Move the own result into the record of the first section, if any section was run.
+     * Afterwards this testcase holds the aggregated result of all its sections.
+     * @return true, if this testcase has sections
+     */
+    auto
+    split_sections() -> bool;
+
+    /// Check whether there are sections that were discovered, but not yet run.
+    auto
+    has_pending_sections() const -> bool;
+
+    /// Make a testcase that runs the next pending section, in a fresh run of the test function.
+    auto
+    next_section() -> testcase;
+
+    /**
+     * Take the result of a section run, and aggregate the own result over all sections.
+     * @return false, if the run resumed after a failed section, but found no section left to run.
+     */
+    auto
+    adopt_section(testcase&& sec_) -> bool;
+
+    /// Get the records of all sections that were run. This is empty, if the testcase has no sections.
+    auto
+    sections() const -> std::vector<testcase> const&;
 
     inline auto
     result() const -> results {
@@ -112,9 +151,33 @@ public:
         return m_err_msg;
     }
 
+    /// Get all previous runs of this testcase, if it was retried. The last run is the actual result.
+    inline auto
+    attempts() const -> std::vector<attempt> const& {
+        return m_attempts;
+    }
+
+    /// Check whether this testcase passed only on a retry.
+    inline auto
+    flaky() const -> bool {
+        return m_result == HAS_PASSED && !m_attempts.empty();
+    }
+
+    /// Check whether this testcase is quarantined, so that its failures do not count.
+    inline auto
+    quarantined() const -> bool {
+        return m_quarantined;
+    }
+
+    /// Get the number of bytes, that were allocated in the arena of the testcase, or the maximum over its sections.
+    inline auto
+    arena_peak() const -> std::size_t {
+        return m_arena_peak;
+    }
+
     inline auto
     name() const -> char const* {
-        return m_name;
+        return m_name_buf.empty() ? m_name : m_name_buf.c_str();
     }
 
     inline auto
@@ -143,6 +206,11 @@ public:
     }
 
 private:
+    friend class generator;
+    friend class testsuite;
+    friend class encoder;
+    friend class decoder;
+
     inline void
     pass() {
         m_result = HAS_PASSED;
@@ -160,15 +228,241 @@ private:
         m_err_msg = msg_;
     }
 
-    char const*   m_name;
-    char const*   m_suite_name;
-    results       m_result{IS_UNDONE};
-    double        m_elapsed_t{.0};
-    std::string   m_err_msg;
-    std::string   m_cout;
-    std::string   m_cerr;
-    test_function m_test_fn;
+    /// Record the last run as previous attempt, so that this testcase can be run again.
+    inline void
+    retry() {
+        m_attempts.push_back(attempt{m_result, m_elapsed_t, std::move(m_err_msg)});
+        m_result = IS_UNDONE;
+        m_err_msg.clear();
+    }
+
+    struct section_state;
+
+    void
+    track_sections(section_tracker& tracker_);
+
+    void
+    rename(std::string&& name_);
+
+    char const*                    m_name;
+    char const*                    m_suite_name;
+    results                        m_result{IS_UNDONE};
+    double                         m_elapsed_t{.0};
+    std::string                    m_err_msg;
+    std::string                    m_cout;
+    std::string                    m_cerr;
+    std::string                    m_name_buf;  ///< Owns the name, if it was built at runtime.
+    test_function                  m_test_fn;
+    std::unique_ptr<section_state> m_sections;  ///< Only allocated, if the testcase has sections.
+    std::vector<attempt>           m_attempts;
+    bool                           m_quarantined{false};
+    std::size_t                    m_arena_peak{0};  ///< Number of bytes allocated in the arena.
+};
+
+struct testcase::section_state
+{
+    section_path                              path;  ///< The target path before, and the path that was run after execution.
+    /// Whether the sections after the known ones below path are run. After execution, whether none was left.
+    bool                                      resume{false};
+    bool                                      aborted{false};  ///< Whether the leaf section failed.
+    std::vector<section_path>                 found;
+    std::deque<std::pair<section_path, bool>> pending;  ///< Paths to run, and whether to resume below them.
+    std::set<section_path>                    known;
+    std::vector<testcase>                     records;
 };
+
+inline testcase::~testcase() noexcept = default;
+
+inline auto
+testcase::operator=(testcase&& other_) noexcept -> testcase& {
+    m_name        = other_.m_name;
+    m_suite_name  = other_.m_suite_name;
+    m_result      = other_.m_result;
+    m_elapsed_t   = other_.m_elapsed_t;
+    m_err_msg     = std::move(other_.m_err_msg);
+    m_cout        = std::move(other_.m_cout);
+    m_cerr        = std::move(other_.m_cerr);
+    m_name_buf    = std::move(other_.m_name_buf);
+    m_test_fn     = std::move(other_.m_test_fn);
+    m_sections    = std::move(other_.m_sections);
+    m_attempts    = std::move(other_.m_attempts);
+    m_quarantined = other_.m_quarantined;
+    m_arena_peak  = other_.m_arena_peak;
+    return *this;
+}
+
+inline void
+testcase::operator()() {
+    lap_timer laps(false);
+    (*this)(laps);
+}
+
+inline void
+testcase::operator()(lap_timer& laps_) {
+    if (m_result != IS_UNDONE) {
+        return;
+    }
+    section_tracker     tracker(m_sections ? m_sections->path : section_path{},
+                                m_sections && m_sections->resume ? &m_sections->known : nullptr);
+    clock::virtual_time time;
+    intern::temp_dir    tmp(m_suite_name, m_name);
+    random::source      rnd(m_suite_name, m_name);
+    intern::arena       mem;
+    {
+        section_tracker::scope const     tracking(&tracker);
+        clock::virtual_time::scope const timing(&time);
+        intern::temp_dir::scope const    files(&tmp);
+        random::source::scope const      randomness(&rnd);
+        intern::arena::scope const       scratch(&mem);
+        auto const                       start{laps_.start()};
+#ifdef TPP_INTERN_NO_EXCEPTIONS
+        auto& failure{assert::current_failure()};
+        failure.failed = false;
+        m_test_fn();
+        if (failure.failed) {
+            fail(failure.msg.c_str());
+        } else {
+            pass();
+        }
+#else
+        try {
+            m_test_fn();
+            pass();
+        } catch (assert::assertion_failure const& e) {
+            fail(e.what());
+        } catch (std::exception const& e) {
+            error(e.what());
+        } catch (...) {
+            error();
+        }
+#endif
+        m_elapsed_t = laps_.stop(start);
+    }
+    if (tmp.created() || mem.reserved() != 0) {
+        laps_.interrupt();  // Cleaning up must not be attributed to the next testcase.
+    }
+    m_arena_peak = mem.high_water();
+    auto const kept{tmp.finish(m_result != HAS_PASSED)};
+    if (!kept.empty()) {
+        m_err_msg.append(" (temporary files kept in ").append(kept).append(")");
+    }
+    if (rnd.used() && m_result != HAS_PASSED) {
+        m_err_msg.append(" (seed: ").append(std::to_string(random::source::seed().load())).append(")");
+    }
+    if (tracker.used()) {
+        track_sections(tracker);
+    }
+}
+
+inline void
+testcase::track_sections(section_tracker& tracker_) {
+    if (!m_sections) {
+        m_sections.reset(new section_state);
+    }
+    m_sections->resume  = m_sections->resume && !tracker_.has_leaf();
+    m_sections->aborted = tracker_.aborted();
+    m_sections->path    = tracker_.leaf();
+    m_sections->found   = tracker_.discovered();
+}
+
+inline auto
+testcase::split_sections() -> bool {
+    if (!m_sections || !m_sections->records.empty()) {
+        return false;
+    }
+    testcase first(test_context{m_name, m_suite_name}, nullptr);
+    first.m_result     = m_result;
+    first.m_elapsed_t  = m_elapsed_t;
+    first.m_err_msg    = m_err_msg;
+    first.m_arena_peak = m_arena_peak;
+    first.m_cout       = std::move(m_cout);
+    first.m_cerr       = std::move(m_cerr);
+    first.m_sections.reset(new section_state);
+    first.m_sections->aborted = m_sections->aborted;
+    first.m_sections->path    = std::move(m_sections->path);
+    first.m_sections->found   = std::move(m_sections->found);
+    m_cout.clear();
+    m_cerr.clear();
+    m_elapsed_t = .0;
+    adopt_section(std::move(first));
+    return true;
+}
+
+inline auto
+testcase::has_pending_sections() const -> bool {
+    return m_sections && !m_sections->pending.empty();
+}
+
+inline auto
+testcase::next_section() -> testcase {
+    testcase sec(test_context{m_name, m_suite_name}, test_function(m_test_fn));
+    sec.m_sections.reset(new section_state);
+    sec.m_sections->path   = std::move(m_sections->pending.front().first);
+    sec.m_sections->resume = m_sections->pending.front().second;
+    if (sec.m_sections->resume) {
+        sec.m_sections->known = m_sections->known;
+    }
+    m_sections->pending.pop_front();
+    return sec;
+}
+
+inline auto
+testcase::adopt_section(testcase&& sec_) -> bool {
+    auto&        state{*m_sections};
+    auto&        sec{*sec_.m_sections};
+    section_path prefix;
+    for (auto const& s : sec.path) {
+        prefix.push_back(s);
+        state.known.insert(prefix);
+    }
+    for (auto& p : sec.found) {
+        if (state.known.insert(p).second) {
+            state.pending.emplace_back(std::move(p), false);
+        }
+    }
+    if (sec.aborted) {
+        // Sections after a failed one were never reached, so resume after it in another run.
+        auto resume{std::make_pair(section_path(sec.path.begin(), sec.path.end() - 1), true)};
+        if (std::find(state.pending.begin(), state.pending.end(), resume) == state.pending.end()) {
+            state.pending.push_back(std::move(resume));
+        }
+    }
+    if (sec.resume && sec_.m_result == HAS_PASSED) {
+        return false;
+    }
+    std::string name{this->name()};
+    for (auto const& s : sec.path) {
+        name.append(" / ").append(s);
+    }
+    sec_.m_name_buf = std::move(name);
+    sec_.m_test_fn  = nullptr;
+    sec_.m_sections.reset();
+    m_elapsed_t += sec_.m_elapsed_t;
+    m_arena_peak = std::max(m_arena_peak, sec_.m_arena_peak);
+    if (sec_.m_result > m_result || state.records.empty()) {
+        m_result  = sec_.m_result;
+        m_err_msg = sec_.m_result == HAS_PASSED ? std::string() : std::string(sec_.name()) + ": " + sec_.m_err_msg;
+    }
+    state.records.push_back(std::move(sec_));
+    return true;
+}
+
+inline auto
+testcase::sections() const -> std::vector<testcase> const& {
+    static std::vector<testcase> const none;
+    return m_sections ? m_sections->records : none;
+}
+
+inline void
+testcase::rename(std::string&& name_) {
+    if (m_sections) {
+        auto const prefix_len{std::string(this->name()).size()};
+        for (auto& r : m_sections->records) {
+            r.m_name_buf.replace(0, prefix_len, name_);
+        }
+    }
+    m_name_buf = std::move(name_);
+}
 }  // namespace test
 }  // namespace intern
 }  // namespace tpp
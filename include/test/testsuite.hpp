@@ -22,13 +22,23 @@
 #include <chrono>
 #include <functional>
 #include <iostream>
+#include <iterator>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "test/generator.hpp"
+#include "test/quarantine.hpp"
+#include "test/run_config.hpp"
 #include "test/statistic.hpp"
 #include "test/streambuf_proxy.hpp"
 #include "test/testcase.hpp"
+#include "test/work_unit.hpp"
+
+#include "fatal.hpp"
 
 namespace tpp
 {
@@ -36,11 +46,19 @@ namespace intern
 {
 namespace test
 {
+/**
+ * Capturing of output, timing of testcases, and the listeners to notify in a run. Only sequential runs chain their
+ * testcases as laps.
+ */
 template<typename T>
 struct streambuf_proxies
 {
-    T cout{std::cout};
-    T cerr{std::cerr};
+    explicit streambuf_proxies(listener_list* listeners_ = nullptr) : listeners(listeners_) {}
+
+    T                    cout{std::cout};
+    T                    cerr{std::cerr};
+    lap_timer            laps{!std::is_same<T, streambuf_proxy_omp>::value};
+    listener_list* const listeners;
 };
 
 class testsuite;
@@ -55,6 +73,7 @@ protected:
 
 public:
     using hook_function = std::function<void()>;
+    using unit_function = std::function<void(std::size_t, unit_result&&)>;
 
     testsuite(testsuite const&)     = delete;
     testsuite(testsuite&&) noexcept = delete;
@@ -69,25 +88,31 @@ public:
         return std::make_shared<testsuite>(enable{}, name_);
     }
 
-    virtual void
+    void
     run() {
+        run(run_config{});
+    }
+
+    virtual void
+    run(run_config const& cfg_) {
         if (m_state != IS_DONE) {
             duration d;
-            m_stats.m_num_tests = m_testcases.size();
-            streambuf_proxies<streambuf_proxy_single> bufs;
+            m_stats.m_num_tests = m_num_cases;
+            streambuf_proxies<streambuf_proxy_single> bufs(cfg_.listeners);
             m_setup_fn();
             std::for_each(m_testcases.begin(), m_testcases.end(), [&](testcase& tc_) {
                 if (tc_.result() == testcase::IS_UNDONE) {
-                    m_pretest_fn();
-                    tc_();
-                    switch (tc_.result()) {
-                        case testcase::HAS_FAILED: ++m_stats.m_num_fails; break;
-                        case testcase::HAD_ERROR: ++m_stats.m_num_errs; break;
-                        default: break;
+                    run_testcase(tc_, bufs, m_stats);
+                }
+            });
+            std::for_each(m_generators.begin(), m_generators.end(), [&](generator& gen_) {
+                if (!gen_.done()) {
+                    for (std::size_t i{0}; i < gen_.size(); ++i) {
+                        auto tc{gen_.make_testcase(i)};
+                        run_testcase(tc, bufs, m_stats);
+                        gen_.record(i, std::move(tc), cfg_.gen_policy);
                     }
-                    m_posttest_fn();
-                    tc_.cout(bufs.cout.str());
-                    tc_.cerr(bufs.cerr.str());
+                    take_results(gen_, cfg_);
                 }
             });
             m_teardown_fn();
@@ -99,6 +124,14 @@ public:
     void
     test(char const* name_, hook_function&& fn_) {
         m_testcases.emplace_back(test_context{name_, m_name}, std::move(fn_));
+        ++m_num_cases;
+        m_state = IS_PENDING;
+    }
+
+    void
+    generate(char const* name_, std::size_t count_, generator_function&& fn_) {
+        m_generators.emplace_back(test_context{name_, m_name}, count_, std::move(fn_));
+        m_num_cases += count_;
         m_state = IS_PENDING;
     }
 
@@ -122,6 +155,35 @@ public:
         m_posttest_fn.fn = std::move(fn_);
     }
 
+    /// Declare that this testsuite uses the global fixture with signature key_.
+    void
+    use_fixture(std::string&& key_) {
+        if (std::find(m_fixtures.begin(), m_fixtures.end(), key_) == m_fixtures.end()) {
+            m_fixtures.push_back(std::move(key_));
+        }
+    }
+
+    /// Keep an object alive as long as this testsuite, like the module, that defines its testcases.
+    void
+    own(std::shared_ptr<void>&& owned_) {
+        m_owned = std::move(owned_);
+    }
+
+    /// Keep only those testcases and generators, whose declared name satisfies pred_. This must be done before running.
+    template<typename Fn>
+    void
+    select(Fn&& pred_) {
+        m_testcases.erase(std::remove_if(m_testcases.begin(), m_testcases.end(),
+                                         [&](testcase const& tc_) { return !pred_(tc_.m_name); }),
+                          m_testcases.end());
+        m_generators.erase(std::remove_if(m_generators.begin(), m_generators.end(),
+                                          [&](generator const& gen_) { return !pred_(gen_.name()); }),
+                           m_generators.end());
+        m_num_cases = m_testcases.size();
+        std::for_each(m_generators.begin(), m_generators.end(),
+                      [&](generator const& gen_) { m_num_cases += gen_.size(); });
+    }
+
     inline auto
     name() const -> char const* {
         return m_name;
@@ -142,9 +204,329 @@ public:
         return m_testcases;
     }
 
+    inline auto
+    generators() const -> std::vector<generator> const& {
+        return m_generators;
+    }
+
+    /// Get the signatures of all global fixtures, that this testsuite declared.
+    inline auto
+    fixtures() const -> std::vector<std::string> const& {
+        return m_fixtures;
+    }
+
+    /// Check whether this testsuite was run, or completed already.
+    inline auto
+    done() const -> bool {
+        return m_state == IS_DONE;
+    }
+
+    /// Check whether testcases of this testsuite are run in parallel.
+    virtual auto
+    parallel() const -> bool {
+        return false;
+    }
+
+    /// Split all pending testcases into units of work, where generators are split into chunks of chunk_ cases.
+    auto
+    units(std::size_t chunk_) const -> std::vector<work_unit> {
+        std::vector<work_unit> u;
+        if (m_state == IS_DONE) {
+            return u;
+        }
+        for (std::size_t i{0}; i < m_testcases.size(); ++i) {
+            if (m_testcases[i].result() == testcase::IS_UNDONE) {
+                u.push_back(work_unit{i, 0, 0});
+            }
+        }
+        for (std::size_t i{0}; i < m_generators.size(); ++i) {
+            if (!m_generators[i].done()) {
+                for (std::size_t b{0}; b < m_generators[i].size(); b += chunk_) {
+                    u.push_back(work_unit{m_testcases.size() + i, b, std::min(b + chunk_, m_generators[i].size())});
+                }
+            }
+        }
+        return u;
+    }
+
+    /// Run SETUP before the first unit of work, unless it was run already.
+    void
+    prepare_units() {
+        if (!m_prepared) {
+            m_setup_fn();
+            m_prepared = true;
+        }
+    }
+
+    /**
+     * Run units of work, and pass the result of each unit to done_ as soon as it is finished, together with its index
+     * in units_. SETUP is run before the first unit.
+     */
+    virtual void
+    run_units(std::vector<work_unit> const& units_, run_config const& cfg_, unit_function const& done_) {
+        prepare_units();
+        streambuf_proxies<streambuf_proxy_single> bufs(cfg_.listeners);
+        for (std::size_t i{0}; i < units_.size(); ++i) {
+            done_(i, run_unit(units_[i], cfg_, bufs));
+            bufs.laps.interrupt();
+        }
+    }
+
+    /// Run TEARDOWN, if any unit of work was run.
+    void
+    finish_units() {
+        if (m_prepared) {
+            m_teardown_fn();
+            m_prepared = false;
+        }
+    }
+
+    /// Merge the results of a unit of work, that was run elsewhere.
+    void
+    merge(unit_result&& res_, run_config const& cfg_) {
+        auto const item{res_.unit.item};
+        if (item < m_testcases.size()) {
+            if (res_.records.size() != 1) {
+                TPP_INTERN_THROW(std::runtime_error("invalid result for testcase"));
+            }
+            m_testcases[item] = std::move(res_.records.front().second);
+            count_merged(m_testcases[item]);
+        } else {
+            auto& gen{generator_at(item)};
+            for (auto& r : res_.records) {
+                count_merged(r.second);
+                gen.record(r.first, std::move(r.second), cfg_.gen_policy);
+            }
+            gen.record_passed(res_.passed_t);
+            m_stats.m_elapsed_t += res_.passed_t;
+        }
+    }
+
+    /// Record erroneous results for a unit of work, that could not be run elsewhere.
+    void
+    lose(work_unit const& u_, char const* reason_, run_config const& cfg_) {
+        unit_result res(u_);
+        auto const  ctx{context(u_.item)};
+        auto const  single{u_.item < m_testcases.size()};
+        for (auto i{single ? u_.item : u_.begin}; i < (single ? u_.item + 1 : u_.end); ++i) {
+            testcase tc(test_context{ctx.tc_name, ctx.ts_name}, nullptr);
+            tc.error(reason_);
+            res.records.emplace_back(i, std::move(tc));
+        }
+        merge(std::move(res), cfg_);
+    }
+
+    /// Complete this testsuite, after the results of all its units of work were merged.
+    void
+    complete(run_config const& cfg_) {
+        if (m_state != IS_DONE) {
+            m_stats.m_num_tests += m_num_cases;
+            std::for_each(m_generators.begin(), m_generators.end(), [&](generator& gen_) {
+                if (!gen_.done()) {
+                    take_results(gen_, cfg_);
+                }
+            });
+            m_state = IS_DONE;
+        }
+    }
+
+    /**
+     * Rerun unsuccessful testcases up to retries_ times, where each round is framed by SETUP and TEARDOWN.
+     * A testcase that passes on a retry is flaky. Generated cases, and testcases with sections are not retried.
+     */
+    void
+    retry(std::size_t retries_) {
+        for (std::size_t r{0}; r < retries_; ++r) {
+            std::vector<testcase*> failed;
+            std::for_each(m_testcases.begin(), m_testcases.end(), [&](testcase& tc_) {
+                if (tc_.result() > testcase::HAS_PASSED && tc_.m_test_fn && !tc_.m_sections) {
+                    uncount_result(tc_, m_stats);
+                    tc_.retry();
+                    failed.push_back(&tc_);
+                }
+            });
+            if (failed.empty()) {
+                return;
+            }
+            duration d;
+            m_setup_fn();
+            rerun(failed);
+            m_teardown_fn();
+            m_stats.m_elapsed_t += d.get();
+            std::for_each(failed.begin(), failed.end(), [&](testcase const* tc_) {
+                count_result(*tc_, m_stats);
+                if (tc_->flaky()) {
+                    ++m_stats.m_num_flaky;
+                }
+            });
+        }
+    }
+
+    /// Mark all testcases, that are in the quarantine list, and count their failures as quarantined.
+    void
+    quarantine(test::quarantine const& q_) {
+        m_stats.m_num_quarantined = 0;
+        std::for_each(m_testcases.begin(), m_testcases.end(), [&](testcase& tc_) {
+            tc_.m_quarantined = q_.contains(m_name, tc_.m_name);
+            if (tc_.m_sections) {
+                std::for_each(tc_.m_sections->records.begin(), tc_.m_sections->records.end(),
+                              [&](testcase& s_) { count_quarantined(s_, tc_.m_quarantined); });
+            } else {
+                count_quarantined(tc_, tc_.m_quarantined);
+            }
+        });
+    }
+
+    /// Get the context of a testcase, or generator by its item index.
+    auto
+    context(std::size_t item_) const -> test_context {
+        if (item_ < m_testcases.size()) {
+            return test_context{m_testcases[item_].m_name, m_name};
+        }
+        if (item_ - m_testcases.size() < m_generators.size()) {
+            return test_context{m_generators[item_ - m_testcases.size()].name(), m_name};
+        }
+        TPP_INTERN_THROW(std::runtime_error("invalid unit of work"));
+    }
+
     testsuite(enable, char const* name_) : m_name(name_), m_create_time(std::chrono::system_clock::now()) {}
 
 protected:
+    template<typename T>
+    void
+    run_testcase(testcase& tc_, streambuf_proxies<T>& bufs_) {
+        m_pretest_fn();
+        if (m_pretest_fn.fn || m_posttest_fn.fn) {
+            bufs_.laps.interrupt();
+        }
+        tc_(bufs_.laps);
+        m_posttest_fn();
+        bufs_.cout.take(tc_.m_cout);
+        bufs_.cerr.take(tc_.m_cerr);
+    }
+
+    /// Run a testcase including all its sections one after another, and count each result in stats_.
+    template<typename T>
+    void
+    run_testcase(testcase& tc_, streambuf_proxies<T>& bufs_, statistic& stats_) {
+        run_testcase(tc_, bufs_);
+        count_result(tc_, stats_);
+        if (tc_.split_sections()) {
+            while (tc_.has_pending_sections()) {
+                auto sec{tc_.next_section()};
+                run_testcase(sec, bufs_);
+                if (tc_.adopt_section(std::move(sec))) {
+                    count_section(tc_.sections().back(), stats_);
+                }
+            }
+        }
+        notify(tc_, bufs_);
+    }
+
+    /// Notify the listeners of a finished testcase. This is not timed as part of the next testcase.
+    template<typename T>
+    void
+    notify(testcase const& tc_, streambuf_proxies<T>& bufs_) {
+        if (bufs_.listeners) {
+            bufs_.listeners->test_end(*this, tc_);
+            bufs_.laps.interrupt();
+        }
+    }
+
+    /// Run retried testcases again, after SETUP was run.
+    virtual void
+    rerun(std::vector<testcase*> const& tcs_) {
+        streambuf_proxies<streambuf_proxy_single> bufs;
+        std::for_each(tcs_.begin(), tcs_.end(), [&](testcase* tc_) { run_testcase(*tc_, bufs); });
+    }
+
+    template<typename T>
+    auto
+    run_unit(work_unit const& u_, run_config const& cfg_, streambuf_proxies<T>& bufs_) -> unit_result {
+        unit_result res(u_);
+        statistic   stats;
+        if (u_.item < m_testcases.size()) {
+            auto& tc{m_testcases[u_.item]};
+            run_testcase(tc, bufs_, stats);
+            res.records.emplace_back(u_.item, std::move(tc));
+        } else {
+            auto const& gen{generator_at(u_.item)};
+            for (auto i{u_.begin}; i < u_.end; ++i) {
+                auto tc{gen.make_testcase(i)};
+                run_testcase(tc, bufs_, stats);
+                res.keep(i, std::move(tc), cfg_.gen_policy);
+            }
+        }
+        return res;
+    }
+
+    auto
+    generator_at(std::size_t item_) -> generator& {
+        if (item_ < m_testcases.size() || item_ - m_testcases.size() >= m_generators.size()) {
+            TPP_INTERN_THROW(std::runtime_error("invalid unit of work"));
+        }
+        return m_generators[item_ - m_testcases.size()];
+    }
+
+    void
+    count_merged(testcase const& tc_) {
+        m_stats.m_elapsed_t += tc_.elapsed_time();
+        if (tc_.sections().empty()) {
+            count_result(tc_, m_stats);
+        } else {
+            m_stats.m_num_tests += tc_.sections().size() - 1;
+            std::for_each(tc_.sections().begin(), tc_.sections().end(),
+                          [&](testcase const& s_) { count_result(s_, m_stats); });
+        }
+    }
+
+    static inline void
+    count_result(testcase const& tc_, statistic& stats_) {
+        switch (tc_.result()) {
+            case testcase::HAS_FAILED: ++stats_.m_num_fails; break;
+            case testcase::HAD_ERROR: ++stats_.m_num_errs; break;
+            default: break;
+        }
+    }
+
+    void
+    count_quarantined(testcase& tc_, bool quarantined_) {
+        tc_.m_quarantined = quarantined_;
+        if (quarantined_ && tc_.result() > testcase::HAS_PASSED) {
+            ++m_stats.m_num_quarantined;
+        }
+    }
+
+    static inline void
+    uncount_result(testcase const& tc_, statistic& stats_) {
+        switch (tc_.result()) {
+            case testcase::HAS_FAILED: --stats_.m_num_fails; break;
+            case testcase::HAD_ERROR: --stats_.m_num_errs; break;
+            default: break;
+        }
+    }
+
+    /// Every section beyond the first one counts as an additional test.
+    static inline void
+    count_section(testcase const& sec_, statistic& stats_) {
+        ++stats_.m_num_tests;
+        count_result(sec_, stats_);
+    }
+
+    static inline void
+    merge_stats(statistic const& from_, statistic& to_) {
+        to_.m_num_tests += from_.m_num_tests;
+        to_.m_num_fails += from_.m_num_fails;
+        to_.m_num_errs += from_.m_num_errs;
+        to_.m_num_flaky += from_.m_num_flaky;
+    }
+
+    void
+    take_results(generator& gen_, run_config const& cfg_) {
+        auto res{gen_.finish(cfg_.gen_policy)};
+        std::move(res.begin(), res.end(), std::back_inserter(m_testcases));
+    }
+
     struct optional_functor final
     {
         void
@@ -163,12 +545,17 @@ protected:
         IS_DONE
     };
 
+    std::shared_ptr<void>                       m_owned;  ///< Destroyed last, as testcases may refer to it.
     char const* const                           m_name;
     std::chrono::system_clock::time_point const m_create_time;
 
-    statistic             m_stats;
-    std::vector<testcase> m_testcases;
-    states                m_state{IS_PENDING};
+    statistic                m_stats;
+    std::vector<testcase>    m_testcases;
+    std::vector<generator>   m_generators;
+    std::vector<std::string> m_fixtures;  ///< Signatures of the global fixtures, that this testsuite uses.
+    std::size_t              m_num_cases{0};
+    states                   m_state{IS_PENDING};
+    bool                     m_prepared{false};  ///< Whether SETUP was run for units of work.
 
     optional_functor m_setup_fn;
     optional_functor m_teardown_fn;
@@ -21,6 +21,8 @@
 #include <cstdint>
 #include <limits>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include "test/testsuite.hpp"
 
@@ -38,51 +40,178 @@ public:
         return std::make_shared<testsuite_parallel>(enable{}, name_);
     }
 
+    using testsuite::run;
+
+    auto
+    parallel() const -> bool override {
+        return true;
+    }
+
     void
-    run() override {
+    run(run_config const& cfg_) override {
         if (m_state != IS_DONE) {
             duration d;
-            if (m_testcases.size() > static_cast<std::size_t>(std::numeric_limits<std::int64_t>::max())) {
-                throw std::overflow_error("Too many testcases! Size would overflow loop variant.");
-            }
-            auto const tc_size{static_cast<std::int64_t>(m_testcases.size())};
-            m_stats.m_num_tests = m_testcases.size();
-            streambuf_proxies<streambuf_proxy_omp> bufs;
+            auto const tc_size{loop_size(m_testcases.size())};
+            m_stats.m_num_tests = m_num_cases;
+            streambuf_proxies<streambuf_proxy_omp> bufs(cfg_.listeners);
+            std::vector<testcase*>                 sectioned;
             m_setup_fn();
 #pragma omp parallel default(shared)
             {  // BEGIN parallel section
-                std::size_t fails{0};
-                std::size_t errs{0};
+                statistic stats;
                 // OpenMP 2 compatible - MSVC not supporting higher version
 #pragma omp for schedule(dynamic)
                 for (std::int64_t i = 0; i < tc_size; ++i) {
                     auto& tc{m_testcases[static_cast<std::size_t>(i)]};
                     if (tc.result() == testcase::IS_UNDONE) {
-                        m_pretest_fn();
-                        tc();
-                        switch (tc.result()) {
-                            case testcase::HAS_FAILED: ++fails; break;
-                            case testcase::HAD_ERROR: ++errs; break;
-                            default: break;
+                        run_testcase(tc, bufs);
+                        count_result(tc, stats);
+                        if (tc.split_sections()) {
+#pragma omp critical
+                            {  // BEGIN critical section
+                                sectioned.push_back(&tc);
+                            }  // END critical section
+                        } else {
+                            notify(tc, bufs);
                         }
-                        m_posttest_fn();
-                        tc.cout(bufs.cout.str());
-                        tc.cerr(bufs.cerr.str());
                     }
                 }
 #pragma omp critical
                 {  // BEGIN critical section
-                    m_stats.m_num_fails += fails;
-                    m_stats.m_num_errs += errs;
+                    merge_stats(stats, m_stats);
                 }  // END critical section
             }      // END parallel section
+            run_sections(std::vector<testcase*>(sectioned), bufs);
+            std::for_each(sectioned.begin(), sectioned.end(), [&](testcase const* tc_) { notify(*tc_, bufs); });
+            std::for_each(m_generators.begin(), m_generators.end(), [&](generator& gen_) {
+                if (!gen_.done()) {
+                    run_generator(gen_, cfg_, bufs);
+                }
+            });
             m_teardown_fn();
             m_state = IS_DONE;
             m_stats.m_elapsed_t += d.get();
         }
     }
 
+    /// Run units of work in parallel. A single chunk of generated cases is run in parallel itself.
+    void
+    run_units(std::vector<work_unit> const& units_, run_config const& cfg_, unit_function const& done_) override {
+        prepare_units();
+        streambuf_proxies<streambuf_proxy_omp> bufs(cfg_.listeners);
+        if (units_.size() == 1 && units_.front().item >= m_testcases.size()) {
+            done_(0, run_chunk(units_.front(), cfg_, bufs));
+            return;
+        }
+        auto const size{loop_size(units_.size())};
+#pragma omp parallel for schedule(dynamic) default(shared)
+        for (std::int64_t i = 0; i < size; ++i) {
+            auto res{run_unit(units_[static_cast<std::size_t>(i)], cfg_, bufs)};
+#pragma omp critical
+            {  // BEGIN critical section
+                done_(static_cast<std::size_t>(i), std::move(res));
+            }  // END critical section
+        }
+    }
+
     testsuite_parallel(enable e_, char const* name_) : testsuite(e_, name_) {}
+
+private:
+    static auto
+    loop_size(std::size_t size_) -> std::int64_t {
+        if (size_ > static_cast<std::size_t>(std::numeric_limits<std::int64_t>::max())) {
+            TPP_INTERN_THROW(std::overflow_error("Too many testcases! Size would overflow loop variant."));
+        }
+        return static_cast<std::int64_t>(size_);
+    }
+
+    /// Run retried testcases again in parallel.
+    void
+    rerun(std::vector<testcase*> const& tcs_) override {
+        streambuf_proxies<streambuf_proxy_omp> bufs;
+        auto const                             size{loop_size(tcs_.size())};
+#pragma omp parallel for schedule(dynamic) default(shared)
+        for (std::int64_t i = 0; i < size; ++i) {
+            run_testcase(*tcs_[static_cast<std::size_t>(i)], bufs);
+        }
+    }
+
+    void
+    run_generator(generator& gen_, run_config const& cfg_, streambuf_proxies<streambuf_proxy_omp>& bufs_) {
+        auto const gen_size{loop_size(gen_.size())};
+#pragma omp parallel default(shared)
+        {  // BEGIN parallel section
+            statistic stats;
+#pragma omp for schedule(dynamic)
+            for (std::int64_t i = 0; i < gen_size; ++i) {
+                auto tc{gen_.make_testcase(static_cast<std::size_t>(i))};
+                run_testcase(tc, bufs_, stats);
+#pragma omp critical
+                {  // BEGIN critical section
+                    gen_.record(static_cast<std::size_t>(i), std::move(tc), cfg_.gen_policy);
+                }  // END critical section
+            }
+#pragma omp critical
+            {  // BEGIN critical section
+                merge_stats(stats, m_stats);
+            }  // END critical section
+        }      // END parallel section
+        take_results(gen_, cfg_);
+    }
+
+    auto
+    run_chunk(work_unit const& u_, run_config const& cfg_, streambuf_proxies<streambuf_proxy_omp>& bufs_)
+      -> unit_result {
+        unit_result res(u_);
+        auto const& gen{generator_at(u_.item)};
+        auto const  begin{loop_size(u_.begin)};
+        auto const  end{loop_size(u_.end)};
+#pragma omp parallel default(shared)
+        {  // BEGIN parallel section
+            statistic stats;
+#pragma omp for schedule(dynamic)
+            for (std::int64_t i = begin; i < end; ++i) {
+                auto tc{gen.make_testcase(static_cast<std::size_t>(i))};
+                run_testcase(tc, bufs_, stats);
+#pragma omp critical
+                {  // BEGIN critical section
+                    res.keep(static_cast<std::size_t>(i), std::move(tc), cfg_.gen_policy);
+                }  // END critical section
+            }
+        }  // END parallel section
+        return res;
+    }
+
+    /**
+     * Run the pending sections of all given testcases in waves. Each wave runs all sections that are known so far
+     * in parallel, and the sections discovered by them are run in the next wave.
+     */
+    void
+    run_sections(std::vector<testcase*>&& parents_, streambuf_proxies<streambuf_proxy_omp>& bufs_) {
+        std::vector<std::pair<testcase*, testcase>> wave;
+        while (!parents_.empty()) {
+            wave.clear();
+            std::for_each(parents_.begin(), parents_.end(), [&](testcase* tc_) {
+                while (tc_->has_pending_sections()) {
+                    wave.emplace_back(tc_, tc_->next_section());
+                }
+            });
+            auto const wave_size{loop_size(wave.size())};
+#pragma omp parallel for schedule(dynamic) default(shared)
+            for (std::int64_t i = 0; i < wave_size; ++i) {
+                run_testcase(wave[static_cast<std::size_t>(i)].second, bufs_);
+            }
+            parents_.clear();
+            std::for_each(wave.begin(), wave.end(), [&](std::pair<testcase*, testcase>& sec_) {
+                if (sec_.first->adopt_section(std::move(sec_.second))) {
+                    count_section(sec_.first->sections().back(), m_stats);
+                }
+                if (sec_.first->has_pending_sections() && (parents_.empty() || parents_.back() != sec_.first)) {
+                    parents_.push_back(sec_.first);
+                }
+            });
+        }
+    }
 };
 }  // namespace test
 }  // namespace intern
@@ -0,0 +1,70 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_TEST_WORK_UNIT_HPP
+#define TPP_TEST_WORK_UNIT_HPP
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "test/run_config.hpp"
+#include "test/testcase.hpp"
+
+namespace tpp
+{
+namespace intern
+{
+namespace test
+{
+/// A unit of work is either a single testcase, or a range of cases of a generator.
+struct work_unit
+{
+    std::size_t item;   ///< Index of the testcase, or of the generator counted after all testcases.
+    std::size_t begin;  ///< First generated case, if item is a generator.
+    std::size_t end;    ///< Last generated case (exclusive), if item is a generator.
+};
+
+/// The results of a unit of work, that was run elsewhere.
+struct unit_result
+{
+    using record = std::pair<std::size_t, testcase>;
+
+    unit_result() = default;
+    explicit unit_result(work_unit const& u_) : unit(u_) {}
+
+    /// Keep the result of a case, or just count it, if it passed and is not reported.
+    void
+    keep(std::size_t idx_, testcase&& tc_, generator_policy pol_) {
+        if (tc_.result() == testcase::HAS_PASSED && pol_ != generator_policy::ALL) {
+            ++passed;
+            passed_t += tc_.elapsed_time();
+        } else {
+            records.emplace_back(idx_, std::move(tc_));
+        }
+    }
+
+    work_unit           unit{};
+    std::vector<record> records;
+    std::size_t         passed{0};     ///< Number of passed cases, that have no record.
+    double              passed_t{.0};  ///< Elapsed time of passed cases, that have no record.
+};
+}  // namespace test
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_TEST_WORK_UNIT_HPP
@@ -25,17 +25,16 @@
 #include "assert/ordering.hpp"
 #include "assert/range.hpp"
 #include "assert/regex.hpp"
+#include "test/fixture_pool.hpp"
 
 #include "api.hpp"
+#include "arena.hpp"
+#include "clock.hpp"
+#include "fixtures.hpp"
+#include "random.hpp"
 #include "regex.hpp"
+#include "registry.hpp"
 #include "runner.hpp"
-
-/**
- * Define a default main function, which performs all tests and allows modification via command line arguments.
- */
-#define TPP_DEFAULT_MAIN                                  \
-    auto main(int argc_, char const** argv_)->int {       \
-        return tpp::runner::instance().run(argc_, argv_); \
-    }
+#include "temp_dir.hpp"
 
 #endif  // TPP_TPP_HPP
@@ -0,0 +1,48 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/// @file
+
+#ifndef TPP_TPP_COMPILED_HPP
+#define TPP_TPP_COMPILED_HPP
+
+/*
+ * Lightweight public header for the tpp_compiled library. It provides the API macros, assertions, and fixtures, while
+ * the runner, reporters, configuration, commandline parsing, and distribution are compiled once into the library.
+ * Neither <regex>, nor file streams are included. Regex assertions are provided by including "assert/regex.hpp" in
+ * addition.
+ */
+#ifndef TPP_COMPILED
+#    define TPP_COMPILED
+#endif
+
+#include "assert/assert.hpp"
+#include "assert/equality.hpp"
+#include "assert/ordering.hpp"
+#include "assert/range.hpp"
+#include "test/fixture_pool.hpp"
+#include "test/testsuite_parallel.hpp"
+
+#include "api.hpp"
+#include "arena.hpp"
+#include "clock.hpp"
+#include "fixtures.hpp"
+#include "random.hpp"
+#include "registry.hpp"
+#include "temp_dir.hpp"
+
+#endif  // TPP_TPP_COMPILED_HPP
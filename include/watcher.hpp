@@ -0,0 +1,145 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TPP_WATCHER_HPP
+#define TPP_WATCHER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cpp_meta.hpp"
+
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+#    include <poll.h>
+#    include <sys/inotify.h>
+#    include <unistd.h>
+#endif
+
+namespace tpp
+{
+namespace intern
+{
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+/**
+ * Watch files for being rewritten, or replaced, like a linker does when it rebuilds them.
+ * The directories of the files are watched, so that replaced files are noticed as well.
+ */
+class watcher
+{
+public:
+    watcher(watcher const&)     = delete;
+    watcher(watcher&&) noexcept = delete;
+    auto
+    operator=(watcher const&) -> watcher& = delete;
+    auto
+    operator=(watcher&&) noexcept -> watcher& = delete;
+
+    explicit watcher(std::vector<std::string> const& paths_) : m_fd(::inotify_init1(IN_CLOEXEC)), m_paths(paths_) {
+        if (m_fd < 0) {
+            throw std::runtime_error("could not watch files");
+        }
+        std::for_each(m_paths.begin(), m_paths.end(), [&](std::string const& p_) {
+            auto const dir{dirname(p_)};
+            auto const wd{::inotify_add_watch(m_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO)};
+            if (wd < 0) {
+                ::close(m_fd);
+                throw std::runtime_error("could not watch " + dir);
+            }
+            m_dirs[wd] = dir;
+        });
+    }
+
+    ~watcher() noexcept {
+        ::close(m_fd);
+    }
+
+    /**
+     * Wait until any of the files has changed, and no change happened afterwards for a short moment.
+     * @param timeout_ms_ is the maximum time to wait for the first change, or -1 to wait forever.
+     * @return the changed files, as they were given, which is empty if the timeout passed.
+     */
+    auto
+    wait(int timeout_ms_ = -1) -> std::vector<std::string> {
+        std::vector<std::string> changed;
+        auto                     timeout{timeout_ms_};
+        while (read_events(timeout, changed)) {
+            timeout = SETTLE_MS;
+        }
+        return changed;
+    }
+
+private:
+    static constexpr int SETTLE_MS = 200;
+
+    static auto
+    dirname(std::string const& path_) -> std::string {
+        auto const pos{path_.rfind('/')};
+        if (pos == std::string::npos) {
+            return ".";
+        }
+        return pos == 0 ? "/" : path_.substr(0, pos);
+    }
+
+    static auto
+    basename(std::string const& path_) -> std::string {
+        auto const pos{path_.rfind('/')};
+        return pos == std::string::npos ? path_ : path_.substr(pos + 1);
+    }
+
+    /// Read available events within timeout_ms_, and add the watched files they refer to. False, if none occurred.
+    auto
+    read_events(int timeout_ms_, std::vector<std::string>& changed_) -> bool {
+        pollfd pfd{m_fd, POLLIN, 0};
+        if (::poll(&pfd, 1, timeout_ms_) <= 0) {
+            return false;
+        }
+        alignas(inotify_event) char buf[4096];
+        auto const                  n{::read(m_fd, buf, sizeof(buf))};
+        if (n <= 0) {
+            return false;
+        }
+        for (std::size_t off{0}; off < static_cast<std::size_t>(n);) {
+            auto const* ev{reinterpret_cast<inotify_event const*>(buf + off)};
+            off += sizeof(inotify_event) + ev->len;
+            auto const dir{m_dirs.find(ev->wd)};
+            if (ev->len == 0 || dir == m_dirs.end()) {
+                continue;
+            }
+            std::for_each(m_paths.begin(), m_paths.end(), [&](std::string const& p_) {
+                if (dirname(p_) == dir->second && basename(p_) == ev->name &&
+                    std::find(changed_.begin(), changed_.end(), p_) == changed_.end()) {
+                    changed_.push_back(p_);
+                }
+            });
+        }
+        return true;
+    }
+
+    int const                  m_fd;
+    std::vector<std::string>   m_paths;
+    std::map<int, std::string> m_dirs;
+};
+#endif
+}  // namespace intern
+}  // namespace tpp
+
+#endif  // TPP_WATCHER_HPP
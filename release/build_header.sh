@@ -3,6 +3,11 @@ set -eo pipefail
 
 FILES="../include/version.hpp
 ../include/cpp_meta.hpp
+../include/fatal.hpp
+../include/clock.hpp
+../include/temp_dir.hpp
+../include/random.hpp
+../include/arena.hpp
 ../include/traits.hpp
 ../include/duration.hpp
 ../include/regex.hpp
@@ -14,11 +19,31 @@ FILES="../include/version.hpp
 ../include/assert/equality.hpp
 ../include/assert/range.hpp
 ../include/assert/regex.hpp
+../include/listener.hpp
+../include/test/run_config.hpp
+../include/test/section.hpp
 ../include/test/testcase.hpp
+../include/test/generator.hpp
+../include/test/work_unit.hpp
+../include/test/codec.hpp
 ../include/test/streambuf_proxy.hpp
+../include/test/quarantine.hpp
 ../include/test/statistic.hpp
 ../include/test/testsuite.hpp
 ../include/test/testsuite_parallel.hpp
+../include/test/dataset.hpp
+../include/test/fixture_store.hpp
+../include/test/fixture_pool.hpp
+../include/registry.hpp
+../include/fixtures.hpp
+../include/net/tcp_socket.hpp
+../include/net/protocol.hpp
+../include/net/coordinator.hpp
+../include/net/worker.hpp
+../include/journal.hpp
+../include/watcher.hpp
+../include/coverage.hpp
+../include/isolation.hpp
 ../include/report/reporter.hpp
 ../include/report/xml_reporter.hpp
 ../include/report/console_reporter.hpp
@@ -0,0 +1,47 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * C++20 module interface of the tpp_compiled library. It exports the helpers, which are usable without macros, for
+ * example in sources with shared test utilities. The macros of the API are not exportable by a module, hence testsuites
+ * include "tpp_compiled.hpp" instead.
+ */
+
+module;
+
+#include "tpp_compiled.hpp"
+
+export module tpp;
+
+export namespace tpp
+{
+using tpp::arena;
+using tpp::arena_allocator;
+using tpp::dataset;
+using tpp::global_fixture;
+using tpp::rng;
+using tpp::temp_dir;
+
+namespace clock
+{
+using tpp::clock::context;
+using tpp::clock::current;
+using tpp::clock::scope;
+using tpp::clock::steady;
+using tpp::clock::system;
+}  // namespace clock
+}  // namespace tpp
@@ -0,0 +1,89 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "tpp_compiled.hpp"
+
+#if defined(TPP_RUNNER_HPP) || defined(TPP_CONFIG_HPP)
+#    error "The runner must not be part of the lightweight header."
+#endif
+#if defined(_GLIBCXX_REGEX) || defined(_GLIBCXX_FSTREAM)
+#    error "The lightweight header must not include <regex>, or <fstream>."
+#endif
+
+#include "assert/regex.hpp"
+
+using tpp::operator""_re;
+
+static std::atomic<int> reached{0};
+
+SUITE("compiled") {
+    GLOBAL_FIXTURE(shared, std::vector<int>);
+
+    SETUP() {
+        shared->push_back(1);
+    };
+    TEST("pass") {
+        ASSERT_EQ(shared->size(), 1U);
+        ASSERT_FALSE(tpp::temp_dir().empty());
+        ++reached;
+    };
+    TEST("fail") {
+        ASSERT_EQ(1, 2);
+    };
+    TEST_GENERATOR("generated", 4, i) {
+        ASSERT_LT(i, 4U);
+        ++reached;
+    };
+    TEST("regex") {
+        ASSERT_MATCH("compiled", "comp.*"_re);
+        ++reached;
+    };
+};
+
+SUITE_PAR("compiled parallel") {
+    FIXTURE_POOL(pool, std::string, 2);
+
+    TEST("pool") {
+        auto s{pool.checkout()};
+        ASSERT_TRUE(s->empty());
+        ++reached;
+    };
+    TEST("sections") {
+        SECTION("a") {
+            ++reached;
+        }
+        SECTION("b") {
+            ++reached;
+        }
+    };
+};
+
+auto
+main(int argc_, char const** argv_) -> int {
+    auto const faults{tpp::intern::run_main(argc_, argv_)};
+    if (faults != 1 || reached != 9) {
+        std::cout << "Running the compiled library has failed! [faults: " << faults << ", reached: " << reached << "]"
+                  << std::endl;
+        return -2;
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+/*
+    Copyright (C) 2017  Jarthianur
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <atomic>
+#include <iostream>
+#include <string>
+
+#include "tpp.hpp"
+
+#ifndef TPP_INTERN_NO_EXCEPTIONS
+#    error "This test must be built with -fno-exceptions."
+#endif
+
+using tpp::operator""_re;
+
+/// Count statements, that are reached after a failed assertion. They must never be reached.
+static std::atomic<int> leaked{0};
+static std::atomic<int> reached{0};
+
+SUITE("noexcept") {
+    TEST("pass") {
+        ASSERT_EQ(1, 1);
+        auto const v{ASSERT_RUNTIME(return 1, 1000.)};
+        ASSERT_EQ(v, 1);
+        ASSERT_EVENTUALLY(reached >= 0, 100);
+        ASSERT_NOTHROW(static_cast<void>(0));
+        ++reached;
+    };
+    TEST("fail") {
+        ASSERT_EQ(1, 2);
+        ++leaked;
+    };
+    TEST("fail in branch") {
+        if (reached >= 0)
+            ASSERT_FALSE(reached >= 0);
+        else
+            ++leaked;
+        ++leaked;
+    };
+    TEST("sections") {
+        SECTION("fail") {
+            ASSERT_TRUE(false);
+            ++leaked;
+        }
+        SECTION("pass") {
+            ASSERT_TRUE(true);
+            ++reached;
+        }
+    };
+    TEST_GENERATOR("generated", 4, i) {
+        ASSERT_LT(i, 2U);
+        ++reached;
+    };
+};
+
+SUITE_PAR("noexcept parallel") {
+    TEST("pass") {
+        ASSERT_IN('b', std::string("abc"));
+        ++reached;
+    };
+    TEST("fail") {
+        ASSERT_MATCH("abc", "b"_re);
+        ++leaked;
+    };
+    TEST("fail in helper") {
+        [] {
+            ASSERT_GT(1, 2);
+            ++leaked;
+        }();
+        ASSERT_TRUE(true);
+        ++leaked;
+    };
+    TEST_GENERATOR("generated", 4, i) {
+        ASSERT_NOT_EQ(i % 2, 1U);
+        ++reached;
+    };
+};
+
+static auto
+parses_cmdline() -> bool {
+    char const*                 argv[]{"noexcept", "-ci", "noexcept*", "--xml"};
+    tpp::intern::cmdline_parser p;
+    p.parse(4, argv);
+    auto const& cfg{p.config()};
+    return !p.help() && cfg.report_fmt == tpp::config::report_format::XML && cfg.report_cfg.color &&
+           cfg.f_mode == tpp::config::filter_mode::INCLUDE && cfg.f_patterns.size() == 1;
+}
+
+auto
+main(int argc_, char const** argv_) -> int {
+    if (!parses_cmdline()) {
+        std::cout << "Parsing the commandline has failed!" << std::endl;
+        return -2;
+    }
+    auto const faults{tpp::runner::instance().run(argc_, argv_)};
+    if (faults != 9 || leaked != 0 || reached != 7) {
+        std::cout << "Leaving testcases without exceptions has failed! [faults: " << faults << ", leaked: " << leaked
+                  << ", reached: " << reached << "]" << std::endl;
+        return -2;
+    }
+    return 0;
+}
@@ -15,9 +15,18 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <atomic>
 #include <chrono>
+#include <csignal>
 #include <cstddef>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -34,6 +43,12 @@
 #    define omp_get_max_threads() 1
 #endif
 
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+#    include <sys/stat.h>
+#    include <sys/wait.h>
+#    include <unistd.h>
+#endif
+
 #ifdef TPP_INTERN_SYS_UNIX
 #    pragma GCC diagnostic push
 #    pragma GCC diagnostic ignored "-Wunused-variable"
@@ -46,14 +61,32 @@ using tpp::config;
 using tpp::reporter_ptr;
 using tpp::runner;
 using tpp::intern::cmdline_parser;
+using tpp::intern::coverage_map;
 using tpp::intern::to_string;
 using tpp::intern::assert::assertion_failure;
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+using tpp::intern::fork_isolation;
+using tpp::intern::net::binary_hash;
+using tpp::intern::net::coordinator;
+using tpp::intern::net::hello_message;
+using tpp::intern::net::message;
+using tpp::intern::net::tcp_socket;
+using tpp::intern::net::worker;
+using tpp::intern::watcher;
+#endif
 using tpp::intern::report::console_reporter;
 using tpp::intern::report::json_reporter;
 using tpp::intern::report::markdown_reporter;
 using tpp::intern::report::reporter_config;
 using tpp::intern::report::reporter_factory;
 using tpp::intern::report::xml_reporter;
+using tpp::intern::test::decoder;
+using tpp::intern::test::encoder;
+using tpp::intern::test::fixture_pool;
+using tpp::intern::test::fixture_store;
+using tpp::intern::test::generator_policy;
+using tpp::intern::test::quarantine;
+using tpp::intern::test::run_config;
 using tpp::intern::test::statistic;
 using tpp::intern::test::testcase;
 using tpp::intern::test::testsuite;
@@ -430,6 +463,29 @@ SUITE_PAR("test_assert_functional") {
                                assertion_failure);
         ASSERT_LIKE(f.what(), "Expected the runtime to be less 10"_re);
     };
+    TEST("assert_eventually") {
+        // successful assertion
+        std::atomic<int> n{0};
+        std::thread      t([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            n = 3;
+        });
+        tpp::intern::duration dur;
+        ASSERT_NOTHROW(ASSERT_EVENTUALLY_EQ(n.load(), 3, 5000));
+        ASSERT_LT(dur.get(), 1000.);
+        t.join();
+        ASSERT_NOTHROW(ASSERT_EVENTUALLY(n == 3, 0));
+        int polls{0};
+        ASSERT_NOTHROW(ASSERT_EVENTUALLY(++polls == 5, 5000));
+        ASSERT_EQ(polls, 5);
+        // failed assertion
+        auto f = ASSERT_THROWS(ASSERT_EVENTUALLY_EQ(++polls, 0, 20), assertion_failure);
+        ASSERT_LIKE(f.what(), ("Expected " + to_string(polls) + " to be equals 0 within 20"));
+        ASSERT_GT(polls, 6);
+        auto g = ASSERT_THROWS(ASSERT_EVENTUALLY(n == 4, 10), assertion_failure);
+        ASSERT_LIKE(g.what(), "Expected false to be equals true within 10"_re);
+        ASSERT_THROWS(ASSERT_EVENTUALLY((throw std::logic_error(""), true), 10), std::logic_error);
+    };
 };
 
 SUITE("test_testsuite_parallel") {
@@ -457,6 +513,19 @@ SUITE("test_testsuite_parallel") {
         ASSERT_EQ(stat.failures(), 1UL);
         ASSERT_EQ(stat.successes(), 2UL);
     };
+    TEST("parallel_retry") {
+        testsuite_ptr    ts = testsuite_parallel::create("ts");
+        std::atomic<int> runs{0};
+        for (int i = 0; i < 4; ++i) {
+            ts->test("", [&] { ASSERT_GT(++runs, 4); });
+        }
+        ts->run();
+        ASSERT_EQ(ts->statistics().failures(), 4UL);
+        ts->retry(1);
+        ASSERT_EQ(runs.load(), 8);
+        ASSERT_EQ(ts->statistics().failures(), 0UL);
+        ASSERT_EQ(ts->statistics().flaky(), 4UL);
+    };
 };
 
 SUITE("test_testsuite") {
@@ -511,6 +580,228 @@ SUITE("test_testsuite") {
         }
         ASSERT_LT(t, ts->statistics().elapsed_time());
     };
+    TEST("retry") {
+        testsuite_ptr ts = testsuite::create("ts");
+        int           runs{0};
+        int           setups{0};
+        ts->setup([&] { ++setups; });
+        ts->test("flaky", [&] { ASSERT_GT(++runs, 2); });
+        ts->test("broken", [] { throw std::logic_error("broken"); });
+        ts->test("passing", [] {});
+        ts->run();
+        ts->retry(3);
+        statistic const& stat = ts->statistics();
+        ASSERT_EQ(stat.tests(), 3UL);
+        ASSERT_EQ(stat.errors(), 1UL);
+        ASSERT_EQ(stat.failures(), 0UL);
+        ASSERT_EQ(stat.flaky(), 1UL);
+        ASSERT_EQ(setups, 4);
+        testcase const& flaky  = ts->testcases().at(0);
+        testcase const& broken = ts->testcases().at(1);
+        ASSERT_TRUE(flaky.flaky());
+        ASSERT_EQ(flaky.attempts().size(), 2UL);
+        ASSERT_EQ(flaky.attempts().at(0).result, testcase::HAS_FAILED);
+        ASSERT_FALSE(broken.flaky());
+        ASSERT_EQ(broken.attempts().size(), 3UL);
+        ASSERT_EQ(broken.reason(), "broken");
+        ASSERT_TRUE(ts->testcases().at(2).attempts().empty());
+    };
+    TEST("quarantine") {
+        testsuite_ptr ts = testsuite::create("ts");
+        ts->test("known flaky", [] { ASSERT_TRUE(false); });
+        ts->test("other", [] { ASSERT_TRUE(false); });
+        ts->generate("gen", 3, [](std::size_t) { ASSERT_TRUE(false); });
+        run_config cfg;
+        cfg.gen_policy = generator_policy::ALL;
+        ts->run(cfg);
+        quarantine q;
+        q.add("ts/known*");
+        q.add("*/gen");
+        ts->quarantine(q);
+        ASSERT_EQ(ts->statistics().failures(), 5UL);
+        ASSERT_EQ(ts->statistics().quarantined(), 4UL);
+        ASSERT_TRUE(ts->testcases().at(0).quarantined());
+        ASSERT_FALSE(ts->testcases().at(1).quarantined());
+        ASSERT_TRUE(ts->testcases().at(4).quarantined());
+        ASSERT_FALSE(q.contains("other", "known flaky"));
+    };
+};
+
+SUITE_PAR("test_generator") {
+    TEST("generate_all") {
+        testsuite_ptr ts = testsuite::create("ts");
+        ts->generate("gen", 10, [](std::size_t i_) { ASSERT_NOT_EQ(i_, 3UL); });
+        run_config cfg;
+        cfg.gen_policy = generator_policy::ALL;
+        ts->run(cfg);
+        ASSERT_EQ(ts->statistics().tests(), 10UL);
+        ASSERT_EQ(ts->statistics().failures(), 1UL);
+        ASSERT_EQ(ts->testcases().size(), 10UL);
+        ASSERT_EQ(ts->testcases().at(3).result(), testcase::HAS_FAILED);
+        ASSERT_EQ(std::string(ts->testcases().at(3).name()), "gen #3");
+        ASSERT_EQ(std::string(ts->testcases().at(3).suite_name()), "ts");
+    };
+    TEST("generate_failed") {
+        testsuite_ptr ts = testsuite_parallel::create("ts");
+        ts->generate("gen", 1000, [](std::size_t i_) {
+            if (i_ % 100 == 99) {
+                throw std::logic_error("err");
+            }
+            ASSERT_NOT_EQ(i_ % 100, 0UL);
+        });
+        ts->run();
+        ASSERT_EQ(ts->statistics().tests(), 1000UL);
+        ASSERT_EQ(ts->statistics().failures(), 10UL);
+        ASSERT_EQ(ts->statistics().errors(), 10UL);
+        ASSERT_EQ(ts->testcases().size(), 20UL);
+        ASSERT_EQ(std::string(ts->testcases().at(0).name()), "gen #0");
+        ASSERT_EQ(std::string(ts->testcases().at(1).name()), "gen #99");
+        ASSERT_EQ(std::string(ts->testcases().back().name()), "gen #999");
+        run_config cfg;
+        cfg.gen_policy = generator_policy::AGGREGATE;
+        ts             = testsuite_parallel::create("ts");
+        ts->generate("gen", 10, [](std::size_t i_) { ASSERT_NOT_EQ(i_, 3UL); });
+        ts->run(cfg);
+        ASSERT_EQ(ts->testcases().size(), 1UL);
+        auto const& summary = ts->testcases().back();
+        ASSERT_EQ(summary.result(), testcase::HAS_FAILED);
+        ASSERT_LIKE(summary.reason(), "^1 of 10 cases failed, 0 erroneous; first at #3: Expected 3"_re);
+    };
+    TEST("reported_faults") {
+        testsuite_ptr ts = testsuite::create("ts");
+        ts->generate("gen", 100, [](std::size_t i_) { ASSERT_NOT_EQ(i_ % 10, 0UL); });
+        ts->generate("pass", 10, [](std::size_t) {});
+        ts->run();
+        std::ostringstream out;
+        reporter_config    rc;
+        rc.ostream = &out;
+        auto rep   = reporter_factory::make<xml_reporter>(rc);
+        rep->begin_report();
+        rep->report(ts);
+        rep->end_report();
+        std::size_t reported{0};
+        for (auto p = out.str().find("<failure "); p != std::string::npos; p = out.str().find("<failure ", p + 1)) {
+            ++reported;
+        }
+        ASSERT_EQ(ts->statistics().failures(), 10UL);
+        ASSERT_EQ(reported, ts->statistics().failures());
+        ASSERT_EQ(ts->testcases().size(), 11UL);
+        ASSERT_EQ(std::string(ts->testcases().back().name()), "pass");
+        ASSERT_EQ(ts->testcases().back().result(), testcase::HAS_PASSED);
+    };
+    TEST("generate_aggregate") {
+        testsuite_ptr ts = testsuite::create("ts");
+        ts->test("tc", [] {});
+        ts->generate("gen", 100, [](std::size_t i_) { std::cout << i_; });
+        run_config cfg;
+        cfg.gen_policy = generator_policy::AGGREGATE;
+        ts->run(cfg);
+        ASSERT_EQ(ts->statistics().tests(), 101UL);
+        ASSERT_EQ(ts->statistics().successes(), 101UL);
+        ASSERT_EQ(ts->testcases().size(), 2UL);
+        ASSERT_EQ(ts->testcases().at(1).result(), testcase::HAS_PASSED);
+        ASSERT_TRUE(ts->testcases().at(1).reason().empty());
+        ts->run(cfg);
+        ASSERT_EQ(ts->testcases().size(), 2UL);
+    };
+};
+
+SUITE_PAR("test_section") {
+    TEST("run_each_leaf") {
+        testsuite_ptr ts   = testsuite::create("ts");
+        int           runs = 0;
+        ts->test("tc", [&] {
+            ++runs;
+            SECTION("A") {
+                SECTION("A1") {}
+                SECTION("A2") {
+                    ASSERT_FALSE(true);
+                }
+            }
+            SECTION("B") {
+                std::cout << "b";
+            }
+        });
+        ts->test("plain", [] {});
+        ts->run();
+        ASSERT_EQ(runs, 3);
+        ASSERT_EQ(ts->statistics().tests(), 4UL);
+        ASSERT_EQ(ts->statistics().failures(), 1UL);
+        auto const& tc = ts->testcases().at(0);
+        ASSERT_EQ(tc.result(), testcase::HAS_FAILED);
+        ASSERT_LIKE(tc.reason(), "^tc / A / A2: Expected"_re);
+        ASSERT_EQ(tc.sections().size(), 3UL);
+        ASSERT_EQ(std::string(tc.sections().at(0).name()), "tc / A / A1");
+        ASSERT_EQ(std::string(tc.sections().at(1).name()), "tc / A / A2");
+        ASSERT_EQ(std::string(tc.sections().at(2).name()), "tc / B");
+        ASSERT_EQ(tc.sections().at(2).cout(), "b");
+        ASSERT_TRUE(ts->testcases().at(1).sections().empty());
+    };
+    TEST("run_parallel") {
+        testsuite_ptr    ts = testsuite_parallel::create("ts");
+        std::atomic<int> runs{0};
+        ts->test("tc", [&] {
+            ++runs;
+            for (auto const* s : {"A", "B", "C"}) {
+                SECTION(s) {
+                    SECTION("1") {}
+                    SECTION("2") {
+                        if (*s == 'C') {
+                            throw std::logic_error("err");
+                        }
+                    }
+                }
+            }
+        });
+        ts->run();
+        ASSERT_EQ(runs.load(), 6);
+        ASSERT_EQ(ts->statistics().tests(), 6UL);
+        ASSERT_EQ(ts->statistics().errors(), 1UL);
+        ASSERT_EQ(ts->testcases().at(0).result(), testcase::HAD_ERROR);
+        ASSERT_EQ(ts->testcases().at(0).sections().size(), 6UL);
+    };
+    TEST("run_after_failure") {
+        for (auto const& ts : {testsuite::create("ts"), testsuite_parallel::create("ts")}) {
+            std::atomic<int> runs{0};
+            ts->test("tc", [&] {
+                ++runs;
+                SECTION("A") {
+                    ASSERT_FALSE(true);
+                }
+                SECTION("B") {
+                    SECTION("B1") {
+                        throw std::logic_error("err");
+                    }
+                    SECTION("B2") {}
+                }
+                SECTION("C") {}
+            });
+            ts->run();
+            ASSERT_EQ(runs.load(), 4);
+            ASSERT_EQ(ts->statistics().tests(), 4UL);
+            ASSERT_EQ(ts->statistics().failures(), 1UL);
+            ASSERT_EQ(ts->statistics().errors(), 1UL);
+            auto const& tc = ts->testcases().at(0);
+            ASSERT_EQ(tc.result(), testcase::HAD_ERROR);
+            ASSERT_EQ(tc.sections().size(), 4UL);
+            ASSERT_EQ(std::string(tc.sections().at(0).name()), "tc / A");
+            ASSERT_EQ(std::string(tc.sections().at(1).name()), "tc / B / B1");
+            ASSERT_EQ(std::string(tc.sections().at(2).name()), "tc / B / B2");
+            ASSERT_EQ(std::string(tc.sections().at(3).name()), "tc / C");
+        }
+    };
+    TEST("generated_with_sections") {
+        testsuite_ptr ts = testsuite::create("ts");
+        ts->generate("gen", 2, [](std::size_t) {
+            SECTION("A") {}
+            SECTION("B") {}
+        });
+        run_config cfg;
+        cfg.gen_policy = generator_policy::ALL;
+        ts->run(cfg);
+        ASSERT_EQ(ts->statistics().tests(), 4UL);
+        ASSERT_EQ(std::string(ts->testcases().at(1).sections().at(1).name()), "gen #1 / B");
+    };
 };
 
 SUITE_PAR("test_testcase") {
@@ -548,6 +839,20 @@ SUITE_PAR("test_testcase") {
         ASSERT(tc2.elapsed_time(), GT, 0.0);
         ASSERT(tc2.reason(), EQ, std::string("unknown error"));
     };
+    TEST("chained_laps") {
+        tpp::intern::lap_timer laps(true);
+        testcase               tc1({"t1", "ctx"}, [] {});
+        testcase               tc2({"t2", "ctx"}, [] {});
+        tc1(laps);
+        auto const end{laps.start()};
+        ASSERT_TRUE(laps.start() == end);
+        tc2(laps);
+        ASSERT_EQ(tc2.result(), testcase::HAS_PASSED);
+        ASSERT(tc2.elapsed_time(), GT, 0.0);
+        ASSERT_TRUE(laps.start() > end);
+        laps.interrupt();
+        ASSERT_TRUE(laps.start() > end);
+    };
 };
 
 SUITE_PAR("test_stringify") {
@@ -648,6 +953,15 @@ DESCRIBE("test_output_capture") {
             ASSERT_EQ(tc.cerr(), std::string("err from ") + to_string(i + 1));
         }
     };
+    IT("should capture no output, if nothing was printed") {
+        auto ts = testsuite::create("ts");
+        ts->test("print", [] { std::cout << "out"; });
+        ts->test("silent", [] {});
+        ts->run();
+        ASSERT_EQ(ts->testcases().at(0).cout(), std::string("out"));
+        ASSERT_TRUE(ts->testcases().at(1).cout().empty());
+        ASSERT_TRUE(ts->testcases().at(1).cerr().empty());
+    };
 };
 
 DESCRIBE("test_suite_meta_functions") {
@@ -1403,7 +1717,838 @@ SUITE_PAR("test_cmdline_parser") {
         std::array<char const*, 3> argv{"test", "-i", "[;+"};
         ASSERT_THROWS(uut.parse(argv.size(), argv.data()), std::runtime_error);
     };
+    TEST("generator report policy") {
+        cmdline_parser             uut;
+        std::array<char const*, 3> argv1{"test", "--gen-report", "all"};
+        std::array<char const*, 3> argv2{"test", "--gen-report", "aggregate"};
+        std::array<char const*, 3> argv3{"test", "--gen-report", "xxx"};
+        std::array<char const*, 2> argv4{"test", "--gen-report"};
+        ASSERT_EQ(uut.config().run_cfg.gen_policy, generator_policy::FAILED);
+        uut.parse(argv1.size(), argv1.data());
+        ASSERT_EQ(uut.config().run_cfg.gen_policy, generator_policy::ALL);
+        uut.parse(argv2.size(), argv2.data());
+        ASSERT_EQ(uut.config().run_cfg.gen_policy, generator_policy::AGGREGATE);
+        ASSERT_THROWS(uut.parse(argv3.size(), argv3.data()), std::runtime_error);
+        ASSERT_THROWS(uut.parse(argv4.size(), argv4.data()), std::runtime_error);
+    };
+    TEST("distribution") {
+        cmdline_parser             uut;
+        cmdline_parser             uut2;
+        cmdline_parser             uut3;
+        std::array<char const*, 3> argv1{"test", "--serve", "4242"};
+        std::array<char const*, 3> argv2{"test", "--worker", "[::1]:4242"};
+        std::array<char const*, 3> argv3{"test", "--serve", "65536"};
+        std::array<char const*, 3> argv4{"test", "--worker", "localhost"};
+        std::array<char const*, 3> argv5{"test", "--worker", "localhost:1"};
+        std::array<char const*, 3> argv6{"test", "--serve", "[::]:4243"};
+        ASSERT_EQ(uut.config().dist, config::dist_mode::LOCAL);
+        uut.parse(argv1.size(), argv1.data());
+        ASSERT_EQ(uut.config().dist, config::dist_mode::SERVE);
+        ASSERT_EQ(uut.config().dist_host, "");
+        ASSERT_EQ(uut.config().dist_port, 4242);
+        uut3.parse(argv6.size(), argv6.data());
+        ASSERT_EQ(uut3.config().dist, config::dist_mode::SERVE);
+        ASSERT_EQ(uut3.config().dist_host, "::");
+        ASSERT_EQ(uut3.config().dist_port, 4243);
+        uut2.parse(argv2.size(), argv2.data());
+        ASSERT_EQ(uut2.config().dist, config::dist_mode::WORKER);
+        ASSERT_EQ(uut2.config().dist_host, "::1");
+        ASSERT_EQ(uut2.config().dist_port, 4242);
+        ASSERT_THROWS(uut.parse(argv3.size(), argv3.data()), std::runtime_error);
+        ASSERT_THROWS(uut.parse(argv4.size(), argv4.data()), std::runtime_error);
+        ASSERT_THROWS(uut.parse(argv5.size(), argv5.data()), std::runtime_error);
+    };
+    TEST("modules") {
+        cmdline_parser             uut;
+        std::array<char const*, 6> argv{"test", "--load", "a.so", "--load", "b.so", "--watch"};
+        ASSERT_FALSE(uut.config().watch);
+        uut.parse(argv.size(), argv.data());
+        ASSERT_EQ(uut.config().modules.size(), 2UL);
+        ASSERT_EQ(uut.config().modules.at(1), "b.so");
+        ASSERT_TRUE(uut.config().watch);
+    };
+    TEST("retries") {
+        cmdline_parser             uut;
+        cmdline_parser             uut2;
+        std::array<char const*, 5> argv{"test", "--retries", "3", "--quarantine", "q.txt"};
+        std::array<char const*, 3> argv2{"test", "--retries", "-1"};
+        ASSERT_EQ(uut.config().run_cfg.retries, 0UL);
+        uut.parse(argv.size(), argv.data());
+        ASSERT_EQ(uut.config().run_cfg.retries, 3UL);
+        ASSERT_EQ(uut.config().quarantine, "q.txt");
+        ASSERT_THROWS(uut2.parse(argv2.size(), argv2.data()), std::runtime_error);
+    };
+    TEST("seed") {
+        cmdline_parser             uut;
+        cmdline_parser             uut2;
+        std::array<char const*, 3> argv{"test", "--seed", "1234567890123"};
+        std::array<char const*, 3> argv2{"test", "--seed", "0x10"};
+        uut.parse(argv.size(), argv.data());
+        ASSERT_TRUE(uut.config().seeded);
+        ASSERT_EQ(uut.config().seed, 1234567890123ULL);
+        ASSERT_THROWS(uut2.parse(argv2.size(), argv2.data()), std::runtime_error);
+        cmdline_parser             uut3;
+        cmdline_parser             uut4;
+        std::array<char const*, 3> argv3{"test", "--seed", "18446744073709551615"};
+        std::array<char const*, 3> argv4{"test", "--seed", "18446744073709551616"};
+        uut3.parse(argv3.size(), argv3.data());
+        ASSERT_EQ(uut3.config().seed, 18446744073709551615ULL);
+        ASSERT_THROWS(uut4.parse(argv4.size(), argv4.data()), std::runtime_error);
+    };
+    TEST("group fixtures") {
+        cmdline_parser             uut;
+        std::array<char const*, 2> argv{"test", "--group-fixtures"};
+        ASSERT_FALSE(uut.config().group_fixtures);
+        uut.parse(argv.size(), argv.data());
+        ASSERT_TRUE(uut.config().group_fixtures);
+    };
+    TEST("fork") {
+        cmdline_parser             uut;
+        std::array<char const*, 2> argv{"test", "--fork"};
+        ASSERT_FALSE(uut.config().isolate);
+        uut.parse(argv.size(), argv.data());
+        ASSERT_TRUE(uut.config().isolate);
+    };
+    TEST("startup profile") {
+        cmdline_parser             uut;
+        std::array<char const*, 2> argv{"test", "--startup-profile"};
+        ASSERT_FALSE(uut.config().startup_profile);
+        uut.parse(argv.size(), argv.data());
+        ASSERT_TRUE(uut.config().startup_profile);
+    };
+    TEST("list") {
+        cmdline_parser             uut;
+        std::array<char const*, 2> argv{"test", "--list"};
+        ASSERT_FALSE(uut.config().list);
+        uut.parse(argv.size(), argv.data());
+        ASSERT_TRUE(uut.config().list);
+    };
+    TEST("keep temp") {
+        cmdline_parser             uut;
+        std::array<char const*, 2> argv{"test", "--keep-temp"};
+        ASSERT_FALSE(uut.config().keep_temp);
+        uut.parse(argv.size(), argv.data());
+        ASSERT_TRUE(uut.config().keep_temp);
+    };
+    TEST("coverage map") {
+        cmdline_parser             uut;
+        std::array<char const*, 5> argv{"test", "--coverage-map", "map", "--changed-files", "a.cpp,,src/b.cpp"};
+        uut.parse(argv.size(), argv.data());
+        ASSERT_EQ(uut.config().coverage_map, "map");
+        ASSERT_TRUE(uut.config().impact);
+        ASSERT_EQ(uut.config().changed_files.size(), 2UL);
+        ASSERT_EQ(uut.config().changed_files.at(1), "src/b.cpp");
+    };
+};
+
+SUITE_PAR("test_coverage_map") {
+    TEST("affected") {
+        coverage_map                   uut;
+        std::set<std::string>          tests;
+        std::vector<std::string> const a{"/b/CMakeFiles/x.dir/src/a.cpp", "/b/CMakeFiles/x.dir/src/common.cpp"};
+        std::vector<std::string> const b{"/b/obj/src/b", "/b/CMakeFiles/x.dir/src/common.cpp"};
+        uut.record("ts/a", a);
+        uut.record("ts/b", b);
+        ASSERT_TRUE(uut.affected(std::vector<std::string>{"./src/a.cpp"}, tests));
+        ASSERT_EQ(tests.size(), 1UL);
+        ASSERT_EQ(*tests.begin(), "ts/a");
+        tests.clear();
+        ASSERT_TRUE(uut.affected(std::vector<std::string>{"src/b.cpp"}, tests));
+        ASSERT_EQ(*tests.begin(), "ts/b");
+        tests.clear();
+        ASSERT_TRUE(uut.affected(std::vector<std::string>{"common.cpp"}, tests));
+        ASSERT_EQ(tests.size(), 2UL);
+        ASSERT_FALSE(uut.affected(std::vector<std::string>{"mon.cpp"}, tests));
+        ASSERT_FALSE(uut.affected(std::vector<std::string>{"src/b.hpp"}, tests));
+        ASSERT_TRUE(uut.contains("ts/a"));
+        ASSERT_FALSE(uut.contains("ts/c"));
+    };
+};
+
+struct tracked_fixture
+{
+    static auto
+    alive() -> std::atomic<int>& {
+        static std::atomic<int> n{0};
+        return n;
+    }
+
+    tracked_fixture() {
+        ++alive();
+    }
+
+    ~tracked_fixture() noexcept {
+        --alive();
+    }
+};
+
+SUITE_PAR("test_fixture_store") {
+    GLOBAL_FIXTURE(t_global, std::vector<int>);
+
+    TEST("obtain_once") {
+        fixture_store fs;
+        int           made{0};
+        auto const    make{[&] {
+            ++made;
+            return std::unique_ptr<int>(new int(42));
+        }};
+        auto& a{fs.obtain<int>("a", make)};
+        ASSERT_EQ(a, 42);
+        ASSERT_EQ(&fs.obtain<int>("a", make), &a);
+        ASSERT_EQ(made, 1);
+        ASSERT_NOT_EQ(static_cast<void*>(&fs.obtain<long>("a", [] { return std::make_shared<long>(1); })),
+                      static_cast<void*>(&a));
+        ASSERT_EQ(fs.size(), 2UL);
+        ASSERT_THROWS(fs.obtain<int>("b", [] { return std::unique_ptr<int>(); }), std::runtime_error);
+    };
+    TEST("construct_concurrently") {
+        fixture_store     fs;
+        std::atomic<bool> building{false};
+        std::atomic<bool> done{false};
+        std::atomic<bool> expired{false};
+        std::atomic<int>  made{0};
+        auto const        fast{fs.obtain<int>("fast", [] { return std::unique_ptr<int>(new int(1)); })};
+        auto const        slow{[&] {
+            return &fs.obtain<int>("slow", [&] {
+                ++made;
+                building = true;
+                auto const deadline{std::chrono::steady_clock::now() + std::chrono::seconds(5)};
+                while (!done && std::chrono::steady_clock::now() < deadline) {
+                    std::this_thread::yield();
+                }
+                expired = !done;
+                return std::unique_ptr<int>(new int(2));
+            });
+        }};
+        int*        p1{nullptr};
+        int*        p2{nullptr};
+        std::thread t1([&] { p1 = slow(); });
+        while (!building) {
+            std::this_thread::yield();
+        }
+        std::thread t2([&] { p2 = slow(); });
+        ASSERT_EQ(fs.obtain<int>("fast", [] { return std::unique_ptr<int>(); }), fast);
+        ASSERT_EQ(fs.obtain<long>("other", [] { return std::unique_ptr<long>(new long(3)); }), 3L);
+        done = true;
+        t1.join();
+        t2.join();
+        ASSERT_FALSE(expired.load());
+        ASSERT_EQ(made.load(), 1);
+        ASSERT_EQ(p1, p2);
+        ASSERT_EQ(*p1, 2);
+    };
+    TEST("release_after_last_user") {
+        fixture_store fs;
+        auto const    key{fixture_store::signature<tracked_fixture>("a")};
+        fs.acquire(key);
+        fs.acquire(key);
+        fs.obtain<tracked_fixture>("a", [] { return std::unique_ptr<tracked_fixture>(new tracked_fixture); });
+        ASSERT_EQ(tracked_fixture::alive().load(), 1);
+        fs.release(key);
+        ASSERT_EQ(fs.size(), 1UL);
+        fs.release(key);
+        ASSERT_EQ(fs.size(), 0UL);
+        ASSERT_EQ(tracked_fixture::alive().load(), 0);
+        fs.release(key);
+    };
+    TEST("declared_by_testsuite") {
+        t_global->push_back(1);
+        ASSERT_EQ(&*t_global, &t_global.get());
+        ASSERT_EQ(t_global->size(), 1UL);
+    };
+};
+
+SUITE_PAR("test_fixture_pool") {
+    FIXTURE_POOL(t_pool, std::vector<int>, 2);
+
+    SETUP() {
+        t_pool.on_reset([](std::vector<int>& v_) { v_.clear(); });
+    };
+
+    TEST("declared_by_testsuite") {
+        auto v{t_pool.checkout()};
+        ASSERT_TRUE(v->empty());
+        v->push_back(1);
+    };
+    TEST("bounded_and_reused") {
+        fixture_pool<std::vector<int>> pool(2);
+        pool.on_reset([](std::vector<int>& v_) { v_.clear(); });
+        std::atomic<int> used{0};
+        std::atomic<int> max_used{0};
+        testsuite_ptr    ts = testsuite_parallel::create("ts");
+        for (int i = 0; i < 8; ++i) {
+            ts->test("use", [&] {
+                auto v{pool.checkout()};
+                auto n{++used};
+                auto m{max_used.load()};
+                while (n > m && !max_used.compare_exchange_weak(m, n)) {
+                }
+                ASSERT_TRUE(v->empty());
+                v->push_back(1);
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                --used;
+            });
+        }
+        ts->run();
+        ASSERT_EQ(ts->statistics().successes(), 8UL);
+        ASSERT_NOT_GT(max_used.load(), 2);
+        auto const st{pool.statistics()};
+        ASSERT_EQ(st.checkouts, 8UL);
+        ASSERT_NOT_GT(st.created, 2UL);
+        ASSERT_EQ(st.created + st.reuses, 8UL);
+    };
+    TEST("wait_for_return") {
+        fixture_pool<int> pool(1);
+        std::thread       t;
+        {
+            auto const first{pool.checkout()};
+            t = std::thread([&] { *pool.checkout() = 2; });
+            while (pool.statistics().checkouts < 2) {
+                std::this_thread::yield();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        t.join();
+        auto const st{pool.statistics()};
+        ASSERT_EQ(st.waits, 1UL);
+        ASSERT_EQ(st.reuses, 1UL);
+        ASSERT_GT(st.max_wait_t, 0.);
+        ASSERT_EQ(st.wait_t, st.max_wait_t);
+        ASSERT_EQ(*pool.checkout(), 2);
+    };
+};
+
+SUITE_PAR("test_clock") {
+    TEST("fast_forward") {
+        auto const                    begin{tpp::clock::steady::now()};
+        auto const                    sys_begin{tpp::clock::system::now()};
+        tpp::intern::duration         real;
+        tpp::intern::virtual_duration virt;
+        tpp::clock::steady::sleep_for(std::chrono::hours(1));
+        ASSERT_LT(real.get(), 1000.);
+        ASSERT_NOT_LT(virt.get(), 3600000.);
+        ASSERT_NOT_LT(tpp::clock::steady::now() - begin, std::chrono::hours(1));
+        ASSERT_NOT_LT(tpp::clock::system::now() - sys_begin, std::chrono::hours(1));
+        tpp::clock::system::sleep_until(tpp::clock::system::now() + std::chrono::minutes(1));
+        ASSERT_NOT_LT(tpp::clock::steady::now() - begin, std::chrono::minutes(61));
+        ASSERT_LT(tpp::clock::current()->skipped(), std::chrono::minutes(62));
+    };
+    TEST("wait_for_all_threads") {
+        auto const               begin{tpp::clock::steady::now()};
+        std::atomic<std::size_t> order{0};
+        std::size_t              main_at{0};
+        std::size_t              thread_at{0};
+        tpp::clock::context      ctx{tpp::clock::current()};
+        std::thread              t([&] {
+            tpp::clock::scope const s(ctx);
+            tpp::clock::steady::sleep_for(std::chrono::minutes(10));
+            thread_at = ++order;
+        });
+        tpp::clock::steady::sleep_for(std::chrono::minutes(5));
+        main_at = ++order;
+        {
+            tpp::clock::scope const idle(nullptr);
+            t.join();
+        }
+        ASSERT_EQ(main_at, 1UL);
+        ASSERT_EQ(thread_at, 2UL);
+        ASSERT_NOT_LT(tpp::clock::steady::now() - begin, std::chrono::minutes(10));
+    };
+    TEST("runtime") {
+        ASSERT_THROWS(ASSERT_RUNTIME(tpp::clock::steady::sleep_for(std::chrono::seconds(1)), 100), assertion_failure);
+        ASSERT_NOTHROW(ASSERT_RUNTIME(tpp::clock::steady::sleep_for(std::chrono::milliseconds(50)), 100));
+    };
+    TEST("real_outside_testcases") {
+        tpp::clock::scope const s(nullptr);
+        ASSERT_NULL(tpp::clock::current());
+        tpp::intern::duration real;
+        tpp::clock::steady::sleep_for(std::chrono::milliseconds(10));
+        ASSERT_NOT_LT(real.get(), 10.);
+    };
+};
+
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+SUITE_PAR("test_temp_dir") {
+    TEST("private_per_testcase") {
+        testsuite_ptr            ts = testsuite_parallel::create("ts");
+        std::mutex               mtx;
+        std::vector<std::string> dirs;
+        for (int i = 0; i < 8; ++i) {
+            ts->test("files", [&] {
+                auto const& dir{tpp::temp_dir()};
+                ASSERT_EQ(&dir, &tpp::temp_dir());
+                std::ofstream(dir + "/data") << dir;
+                std::string   content;
+                std::ifstream in(dir + "/data");
+                in >> content;
+                ASSERT_EQ(content, dir);
+                std::lock_guard<std::mutex> lk(mtx);
+                dirs.push_back(dir);
+            });
+        }
+        ts->run();
+        ASSERT_EQ(ts->statistics().successes(), 8UL);
+        std::sort(dirs.begin(), dirs.end());
+        ASSERT_EQ(std::unique(dirs.begin(), dirs.end()), dirs.end());
+        for (auto const& d : dirs) {
+            ASSERT_FALSE(std::ifstream(d + "/data").good());
+        }
+        bool        thrown{false};
+        std::thread t([&] {
+            try {
+                tpp::temp_dir();
+            } catch (std::logic_error const&) {
+                thrown = true;
+            }
+        });
+        t.join();
+        ASSERT_TRUE(thrown);
+    };
+    TEST("kept_on_failure") {
+        testsuite_ptr ts = testsuite::create("ts");
+        std::string   dir;
+        ts->test("fails", [&] {
+            dir = tpp::temp_dir();
+            std::ofstream(dir + "/data") << "data";
+            ASSERT_TRUE(false);
+        });
+        tpp::intern::temp_dir::keep_failed() = true;
+        ts->run();
+        tpp::intern::temp_dir::keep_failed() = false;
+        ASSERT_TRUE(std::ifstream(dir + "/data").good());
+        ASSERT_IN(dir, std::string(ts->testcases().at(0).reason()));
+        std::remove((dir + "/data").c_str());
+        std::remove(dir.c_str());
+    };
+};
+
+SUITE_PAR("test_arena") {
+    TEST("per_testcase") {
+        testsuite_ptr ts = testsuite_parallel::create("ts");
+        ts->test("graph", [] {
+            std::vector<int, tpp::arena_allocator<int>> v;
+            v.resize(100000);
+            ASSERT_EQ(&v.get_allocator().resource(), &tpp::arena());
+            ASSERT_NOT_LT(tpp::arena().high_water(), 400000UL);
+        });
+        ts->test("none", [] {});
+        ts->run();
+        ASSERT_EQ(ts->statistics().successes(), 2UL);
+        ASSERT_NOT_LT(ts->testcases().at(0).arena_peak(), 400000UL);
+        ASSERT_EQ(ts->testcases().at(1).arena_peak(), 0UL);
+        bool        thrown{false};
+        std::thread t([&] {
+            try {
+                tpp::arena();
+            } catch (std::logic_error const&) {
+                thrown = true;
+            }
+        });
+        t.join();
+        ASSERT_TRUE(thrown);
+    };
+    TEST("monotonic") {
+        tpp::intern::arena a;
+        auto const*        c{static_cast<char*>(a.allocate(1, 1))};
+        auto const*        p{a.allocate(8, 64)};
+        ASSERT_EQ(reinterpret_cast<std::uintptr_t>(p) % 64, 0UL);
+        ASSERT_GT(static_cast<char const*>(p), c);
+        a.allocate(1 << 20);
+        ASSERT_NOT_LT(a.reserved(), a.high_water());
+        ASSERT_NOT_LT(a.high_water(), (1UL << 20) + 9);
+#ifdef TPP_INTERN_HAS_PMR
+        std::pmr::vector<int> v(&a);
+        v.assign(1000, 1);
+        ASSERT_NOT_LT(a.high_water(), (1UL << 20) + 4009);
+#endif
+        a.release();
+        ASSERT_EQ(a.high_water(), 0UL);
+    };
+};
+
+SUITE_PAR("test_dataset") {
+    TEST("cached") {
+        using tpp::intern::test::dataset;
+        auto const  path{"/tmp/tpp_test_dataset_" + std::to_string(::getpid())};
+        std::size_t made{0};
+        auto const  make{[&] {
+            ++made;
+            return std::vector<std::uint64_t>{1, 2, 3};
+        }};
+        auto const first{dataset<std::uint64_t>::load(path, "v1", make)};
+        ASSERT_FALSE(first->mapped());
+        auto const second{dataset<std::uint64_t>::load(path, "v1", make)};
+        ASSERT_TRUE(second->mapped());
+        ASSERT_EQ(made, 1UL);
+        ASSERT_EQ(second->size(), 3UL);
+        ASSERT_TRUE(std::equal(first->begin(), first->end(), second->begin()));
+        ASSERT_EQ((*second)[2], 3UL);
+        ASSERT_FALSE(dataset<std::uint64_t>::load(path, "v2", make)->mapped());
+        ASSERT_FALSE(dataset<std::uint32_t>::load(path, "v2", [] { return std::vector<std::uint32_t>{1}; })->mapped());
+        ASSERT_EQ(::truncate(path.c_str(), 70), 0);
+        ASSERT_FALSE(dataset<std::uint32_t>::load(path, "v2", [] { return std::vector<std::uint32_t>{1}; })->mapped());
+        ASSERT_EQ(made, 2UL);
+        ASSERT_FALSE(dataset<std::uint64_t>::load(path, "v1", make)->mapped());
+        std::uint64_t const overflowing{(1ULL << 61U) + 1};
+        std::fstream        f(path, std::ios::binary | std::ios::in | std::ios::out);
+        f.seekp(24).write(reinterpret_cast<char const*>(&overflowing), sizeof(overflowing)).flush();
+        ASSERT_EQ(::truncate(path.c_str(), 72), 0);
+        ASSERT_FALSE(dataset<std::uint64_t>::load(path, "v1", make)->mapped());
+        ASSERT_EQ(made, 4UL);
+        std::remove(path.c_str());
+    };
+    TEST("private_dir") {
+        using tpp::intern::test::private_dir;
+        auto const dir{"/tmp/tpp_test_cache_" + std::to_string(::getpid())};
+        auto const link{dir + "_link"};
+        ASSERT_TRUE(private_dir(dir));
+        ASSERT_TRUE(private_dir(dir));
+        ASSERT_EQ(::symlink(dir.c_str(), link.c_str()), 0);
+        ASSERT_FALSE(private_dir(link));
+        ASSERT_EQ(::chmod(dir.c_str(), 0755), 0);
+        ASSERT_FALSE(private_dir(dir));
+        std::remove(link.c_str());
+        ASSERT_EQ(::rmdir(dir.c_str()), 0);
+    };
+    TEST("shared") {
+        auto const            key{"tpp_test_dataset_" + std::to_string(::getpid())};
+        std::atomic<unsigned> made{0};
+        testsuite_ptr         ts = testsuite_parallel::create("ts");
+        for (int i = 0; i < 8; ++i) {
+            ts->test("data", [&] {
+                auto const& d{tpp::dataset<int>(key.c_str(), "v1", [&] {
+                    ++made;
+                    return std::vector<int>(1000, 7);
+                })};
+                ASSERT_EQ(d.size(), 1000UL);
+                ASSERT_EQ(d[999], 7);
+                ASSERT_EQ(&d, &tpp::dataset<int>(key.c_str(), "v1", [] { return std::vector<int>(); }));
+            });
+        }
+        ts->run();
+        ASSERT_EQ(ts->statistics().successes(), 8UL);
+        ASSERT_EQ(made.load(), 1U);
+        std::remove(tpp::intern::test::dataset_file(key).c_str());
+    };
+    TEST("generated_concurrently") {
+        auto const        slow{"tpp_test_dataset_slow_" + std::to_string(::getpid())};
+        auto const        fast{"tpp_test_dataset_fast_" + std::to_string(::getpid())};
+        std::atomic<bool> generating{false};
+        std::atomic<bool> done{false};
+        std::atomic<bool> expired{false};
+        std::remove(tpp::intern::test::dataset_file(slow).c_str());
+        std::thread t([&] {
+            tpp::dataset<int>(slow.c_str(), "v1", [&] {
+                generating = true;
+                auto const deadline{std::chrono::steady_clock::now() + std::chrono::seconds(5)};
+                while (!done && std::chrono::steady_clock::now() < deadline) {
+                    std::this_thread::yield();
+                }
+                expired = !done;
+                return std::vector<int>(10, 1);
+            });
+        });
+        while (!generating) {
+            std::this_thread::yield();
+        }
+        ASSERT_EQ(tpp::dataset<int>(fast.c_str(), "v1", [] { return std::vector<int>(10, 2); }).size(), 10UL);
+        done = true;
+        t.join();
+        ASSERT_FALSE(expired.load());
+        std::remove(tpp::intern::test::dataset_file(slow).c_str());
+        std::remove(tpp::intern::test::dataset_file(fast).c_str());
+    };
+};
+
+SUITE("test_random") {
+    std::uint64_t t_seed{0};
+
+    SETUP() {
+        t_seed = tpp::intern::random::source::seed();
+    };
+    TEARDOWN() {
+        tpp::intern::random::source::seed() = t_seed;
+    };
+
+    TEST("deterministic") {
+        auto const draw{[](std::uint64_t seed_) {
+            std::map<std::string, std::uint64_t> values;
+            std::mutex                           mtx;
+            auto const                           record{[&](std::string const& name_) {
+                auto const                  v{tpp::rng()()};
+                std::lock_guard<std::mutex> lk(mtx);
+                values[name_] = v;
+            }};
+            testsuite_ptr ts = testsuite_parallel::create("ts");
+            ts->test("a", [&] { record("a"); });
+            ts->test("b", [&] { record("b"); });
+            ts->generate("gen", 2, [&](std::size_t i_) { record("gen" + std::to_string(i_)); });
+            tpp::intern::random::source::seed() = seed_;
+            ts->run();
+            return values;
+        }};
+        auto const first{draw(42)};
+        auto const second{draw(42)};
+        ASSERT_EQ(first.size(), 4UL);
+        ASSERT_TRUE(first == second);
+        ASSERT_NOT_EQ(first.at("a"), first.at("b"));
+        ASSERT_NOT_EQ(first.at("gen0"), first.at("gen1"));
+        ASSERT_NOT_EQ(first.at("a"), draw(43).at("a"));
+    };
+    TEST("seed_in_failure") {
+        testsuite_ptr ts = testsuite::create("ts");
+        ts->test("random", [] {
+            std::uniform_int_distribution<int> dist(1, 6);
+            ASSERT_GT(dist(tpp::rng()), 6);
+        });
+        ts->test("not random", [] { ASSERT_TRUE(false); });
+        tpp::intern::random::source::seed() = 42;
+        ts->run();
+        ASSERT_IN("(seed: 42)", std::string(ts->testcases().at(0).reason()));
+        ASSERT_NOT_IN("seed", std::string(ts->testcases().at(1).reason()));
+    };
+    TEST("outside_testcases") {
+        std::uint64_t v{0};
+        std::thread   t([&] { v = tpp::rng()() | tpp::rng()(); });
+        t.join();
+        ASSERT_NOT_EQ(v, 0UL);
+    };
+};
+
+SUITE("test_watcher") {
+    TEST("notice_rewrite") {
+        auto const dir{"/tmp/tpp_test_watch_" + std::to_string(::getpid())};
+        auto const file{dir + "/module.so"};
+        ASSERT_EQ(::mkdir(dir.c_str(), 0755), 0);
+        std::ofstream(file) << "old";
+        {
+            watcher w({file, "missing.so"});
+            ASSERT_TRUE(w.wait(0).empty());
+            std::ofstream(dir + "/other") << "other";
+            ASSERT_TRUE(w.wait(100).empty());
+            std::ofstream(file) << "new";
+            ASSERT_EQ(w.wait(1000), std::vector<std::string>{file});
+            std::ofstream(dir + "/tmp") << "newer";
+            ASSERT_EQ(std::rename((dir + "/tmp").c_str(), file.c_str()), 0);
+            ASSERT_EQ(w.wait(1000), std::vector<std::string>{file});
+        }
+        std::remove(file.c_str());
+        std::remove((dir + "/other").c_str());
+        ASSERT_EQ(::rmdir(dir.c_str()), 0);
+        ASSERT_THROWS(watcher({"/nonexistent/module.so"}), std::runtime_error);
+    };
+};
+
+SUITE("test_distributed") {
+    static auto
+    make_suites() -> std::vector<testsuite_ptr> {
+        std::vector<testsuite_ptr> s{testsuite::create("seq"), testsuite_parallel::create("par")};
+        s[0]->test("pass", [] {});
+        s[0]->test("fail", [] { ASSERT_TRUE(false); });
+        s[0]->test("sections", [] {
+            SECTION("A") {}
+            SECTION("B") {
+                std::cout << "b";
+            }
+        });
+        s[1]->test("err", [] { throw std::logic_error("err"); });
+        for (int i = 0; i < 10; ++i) {
+            s[1]->test("pass", [] {});
+        }
+        s[1]->generate("gen", 100, [](std::size_t i_) { ASSERT_NOT_EQ(i_, 42UL); });
+        return s;
+    }
+
+    /// Run a fake worker, that is either rejected, or dies after it got work.
+    static auto
+    fake_worker(std::uint16_t port_, std::uint64_t hash_) -> message {
+        auto        s{tcp_socket::connect("127.0.0.1", port_)};
+        std::string msg;
+        s.send(hello_message(hash_, 4));
+        s.recv(msg);
+        if (msg.at(0) == static_cast<char>(message::WELCOME)) {
+            s.recv(msg);
+        }
+        return static_cast<message>(msg.at(0));
+    }
+
+    static void
+    assert_results(std::vector<testsuite_ptr> const& s_) {
+        ASSERT_EQ(s_[0]->statistics().tests(), 4UL);
+        ASSERT_EQ(s_[0]->statistics().failures(), 1UL);
+        ASSERT_EQ(s_[0]->testcases().at(2).sections().size(), 2UL);
+        ASSERT_EQ(s_[0]->testcases().at(2).sections().at(1).cout(), "b");
+        ASSERT_EQ(s_[1]->statistics().tests(), 111UL);
+        ASSERT_EQ(s_[1]->statistics().errors(), 1UL);
+        ASSERT_EQ(s_[1]->statistics().failures(), 1UL);
+        ASSERT_EQ(s_[1]->testcases().size(), 12UL);
+        ASSERT_EQ(std::string(s_[1]->testcases().at(11).name()), "gen #42");
+    }
+
+    TEST("serve_and_work") {
+        auto const  cs{make_suites()};
+        auto const  ws{make_suites()};
+        std::string err;
+        coordinator coord("", 0, 16);
+        std::thread t([&] {
+            try {
+                worker("localhost", coord.port()).run(ws, 4);
+            } catch (std::exception const& e) {
+                err = e.what();
+            }
+        });
+        coord.run(cs, {0, 1}, run_config{});
+        t.join();
+        ASSERT_EQ(err, "");
+        assert_results(cs);
+    };
+    TEST("reject_and_reassign") {
+        auto const  cs{make_suites()};
+        auto const  ws{make_suites()};
+        std::string err;
+        message     rejected{};
+        message     lost{};
+        coordinator coord("", 0, 16);
+        std::thread t([&] {
+            try {
+                rejected = fake_worker(coord.port(), binary_hash() + 1);
+                lost     = fake_worker(coord.port(), binary_hash());
+                worker("127.0.0.1", coord.port()).run(ws, 4);
+            } catch (std::exception const& e) {
+                err = e.what();
+            }
+        });
+        coord.run(cs, {0, 1}, run_config{});
+        t.join();
+        ASSERT_EQ(err, "");
+        ASSERT_TRUE(rejected == message::REJECT);
+        ASSERT_TRUE(lost == message::WORK);
+        assert_results(cs);
+    };
+    TEST("give_up_lost_work") {
+        auto const  cs{make_suites()};
+        auto const  ws{make_suites()};
+        std::string err;
+        coordinator coord("", 0, 16, 1);
+        std::thread t([&] {
+            try {
+                fake_worker(coord.port(), binary_hash());
+                worker("127.0.0.1", coord.port()).run(ws, 4);
+            } catch (std::exception const& e) {
+                err = e.what();
+            }
+        });
+        coord.run(cs, {0, 1}, run_config{});
+        t.join();
+        ASSERT_EQ(err, "");
+        ASSERT_EQ(cs[0]->statistics().tests(), 3UL);
+        ASSERT_EQ(cs[0]->statistics().errors(), 3UL);
+        ASSERT_EQ(cs[0]->testcases().at(0).reason(), "worker lost while running this testcase");
+        ASSERT_EQ(cs[1]->statistics().tests(), 111UL);
+    };
+    TEST("catalog_and_pool") {
+        auto const  ws1{make_suites()};
+        auto const  ws2{make_suites()};
+        std::string err;
+        coordinator coord("", 0, 16);
+        coord.release_idle();
+        auto const id{coord.expect(binary_hash(), "x/", [](char const* n_) { return std::string(n_) != "x/none"; })};
+        ASSERT_FALSE(coord.cataloged(id));
+        std::thread t([&] {
+            try {
+                std::thread t2([&] { worker("127.0.0.1", coord.port()).run(ws2, 1); });
+                worker("127.0.0.1", coord.port()).run(ws1, 1);
+                t2.join();
+            } catch (std::exception const& e) {
+                err = e.what();
+            }
+        });
+        while (!coord.done()) {
+            coord.poll(run_config{}, -1);
+        }
+        coord.finish(run_config{});
+        t.join();
+        ASSERT_EQ(err, "");
+        ASSERT_TRUE(coord.cataloged(id));
+        auto const cs{coord.suites(id)};
+        ASSERT_EQ(cs.size(), 2UL);
+        ASSERT_EQ(std::string(cs[0]->name()), "x/seq");
+        ASSERT_TRUE(cs[1]->parallel());
+        assert_results(cs);
+    };
+    TEST("reject_deep_sections") {
+        auto const nested = [](unsigned depth_) {
+            encoder e;
+            for (unsigned i{0}; i <= depth_; ++i) {
+                e.u8(0).f64(0.0).str("").str("").str("").str("").u64(0).u64(i < depth_ ? 1 : 0);
+            }
+            return e.data();
+        };
+        auto const ok{nested(decoder::MAX_DEPTH)};
+        auto const deep{nested(decoder::MAX_DEPTH + 1)};
+        ASSERT_NOTHROW(decoder(ok).tc({"tc", "ts"}));
+        ASSERT_THROWS(decoder(deep).tc({"tc", "ts"}), std::runtime_error);
+    };
+    TEST("time_out_stalled_workers") {
+        auto const  cs{make_suites()};
+        auto const  ws{make_suites()};
+        std::string err;
+        bool        oversized{true};
+        coordinator coord("", 0, 16);
+        coord.timeout(std::chrono::milliseconds(200));
+        std::thread t([&] {
+            try {
+                std::string msg;
+                auto        partial{tcp_socket::connect("127.0.0.1", coord.port())};
+                auto        hung{tcp_socket::connect("127.0.0.1", coord.port())};
+                auto        big{tcp_socket::connect("127.0.0.1", coord.port())};
+                ::send(partial.fd(), "\x10", 1, MSG_NOSIGNAL);
+                hung.send(hello_message(binary_hash(), 4));
+                hung.recv(msg);
+                hung.recv(msg);
+                ::send(big.fd(), "\xff\xff\xff\xff", 4, MSG_NOSIGNAL);
+                oversized = big.recv(msg);
+                worker("127.0.0.1", coord.port()).run(ws, 4);
+            } catch (std::exception const& e) {
+                err = e.what();
+            }
+        });
+        coord.run(cs, {0, 1}, run_config{});
+        t.join();
+        ASSERT_EQ(err, "");
+        ASSERT_FALSE(oversized);
+        assert_results(cs);
+    };
+    TEST("relist_after_lost_catalog") {
+        auto const  ws{make_suites()};
+        std::string err;
+        message     asked{};
+        coordinator coord("", 0, 16);
+        coord.timeout(std::chrono::milliseconds(200));
+        auto const id{coord.expect(binary_hash(), "x/", [](char const*) { return true; })};
+        std::thread t([&] {
+            try {
+                std::string msg;
+                auto        hung{tcp_socket::connect("127.0.0.1", coord.port())};
+                hung.send(hello_message(binary_hash(), 1));
+                hung.recv(msg);
+                asked = static_cast<message>(msg.at(0));
+                worker("127.0.0.1", coord.port()).run(ws, 1);
+            } catch (std::exception const& e) {
+                err = e.what();
+            }
+        });
+        while (!coord.done()) {
+            coord.poll(run_config{}, -1);
+        }
+        coord.finish(run_config{});
+        t.join();
+        ASSERT_EQ(err, "");
+        ASSERT_TRUE(asked == message::LIST);
+        assert_results(coord.suites(id));
+    };
 };
+#endif
 
 SUITE("test_runner") {
     class nullbuf : public std::streambuf
@@ -1470,6 +2615,339 @@ SUITE("test_runner") {
         ASSERT_EQ(t_ts2->statistics().elapsed_time(), .0);
         ASSERT_EQ(t_ts2->statistics().tests(), 0UL);
     };
+    TEST("global fixtures") {
+        auto const run{[&](bool group_) {
+            auto const                                       ts3{testsuite::create("testsuite3")};
+            tpp::intern::fixture_handle<tracked_fixture> const f1(t_ts1, "tracked");
+            tpp::intern::fixture_handle<tracked_fixture> const f3(ts3, "tracked");
+            tracked_fixture const*                           used{nullptr};
+            int                                              alive{-1};
+            t_ts1->test("use", [&] { used = &*f1; });
+            t_ts2->test("other", [&] { alive = tracked_fixture::alive(); });
+            ts3->test("use", [&] { ASSERT_EQ(f3.operator->(), used); });
+            config c;
+            c.report_cfg.ostream = &t_null;
+            c.group_fixtures     = group_;
+            runner r;
+            r.add_testsuite(t_ts1);
+            r.add_testsuite(t_ts2);
+            r.add_testsuite(ts3);
+            ASSERT_EQ(r.run(c), 0);
+            ASSERT_EQ(tracked_fixture::alive().load(), 0);
+            t_ts1 = testsuite::create("testsuite1");
+            t_ts2 = testsuite::create("testsuite2");
+            return alive;
+        }};
+        ASSERT_EQ(run(false), 1);
+        ASSERT_EQ(run(true), 0);
+    };
+    TEST("listeners") {
+        struct recorder : tpp::listener
+        {
+            void
+            on_run_start() override {
+                events += "run ";
+            }
+            void
+            on_suite_start(tpp::suite_result const& ts_) override {
+                events += std::string("start:") + ts_.name() + ' ';
+            }
+            void
+            on_test_end(tpp::suite_result const&, tpp::test_result const& tc_) override {
+                ++tests;
+                failed += tc_.result() == tpp::test_result::HAS_FAILED ? 1 : 0;
+            }
+            void
+            on_suite_end(tpp::suite_result const& ts_) override {
+                events += std::string("end:") + ts_.name() + ' ';
+            }
+            void
+            on_run_end() override {
+                events += "done";
+            }
+
+            std::string events;
+            std::size_t tests{0};
+            std::size_t failed{0};
+        };
+        auto const ts3{testsuite_parallel::create("testsuite3")};
+        ts3->test("fail", [] { ASSERT_TRUE(false); });
+        ts3->generate("gen", 100, [](std::size_t i_) { ASSERT_LT(i_, 100UL); });
+        auto const l1{std::make_shared<recorder>()};
+        auto const l2{std::make_shared<recorder>()};
+        config     c;
+        c.report_cfg.ostream = &t_null;
+        runner r;
+        r.add_testsuite(t_ts1);
+        r.add_testsuite(ts3);
+        r.add_listener(l1);
+        r.add_listener(l2);
+        ASSERT_EQ(r.run(c), 1);
+        ASSERT_EQ(l1->events, "run start:testsuite1 end:testsuite1 start:testsuite3 end:testsuite3 done");
+        ASSERT_EQ(l1->tests, 102UL);
+        ASSERT_EQ(l1->failed, 1UL);
+        ASSERT_EQ(l2->tests, 102UL);
+        ASSERT_EQ(r.run(c), 1);
+        ASSERT_EQ(l1->tests, 102UL + t_ts1->testcases().size() + ts3->testcases().size());
+        ASSERT_EQ(l1->failed, 2UL);
+    };
+    TEST("static registration") {
+        auto const&                          reg{tpp::intern::registered_suites()};
+        std::vector<std::string>             names;
+        tpp::intern::suite_descriptor const* last{nullptr};
+        for (auto const* d{reg.head}; d; d = d->next) {
+            names.emplace_back(d->name);
+            last = d;
+        }
+        ASSERT_EQ(names.size(), reg.count);
+        ASSERT_EQ(last, reg.tail);
+        auto const first{std::find(names.begin(), names.end(), "test_assert")};
+        ASSERT_TRUE(first != names.end());
+        ASSERT_TRUE(std::find(first, names.end(), "test_runner") != names.end());
+    };
+    TEST("list") {
+        std::size_t const line{__LINE__ - 1};
+        auto              found{false};
+        for (auto const* t{tpp::intern::registered_suites().tests}; t; t = t->next) {
+            if (std::string(t->decl.suite->name) == "test_runner" && std::string(t->decl.name) == "list") {
+                ASSERT_EQ(t->decl.line, line);
+                ASSERT_EQ(std::string(t->decl.file), __FILE__);
+                found = true;
+            }
+        }
+        ASSERT_TRUE(found);
+        std::ostringstream out;
+        config             c;
+        c.report_cfg.ostream = &out;
+        c.list               = true;
+        t_ts2->generate("gen", 10, [](std::size_t) {});
+        runner r;
+        r.add_testsuite(t_ts1);
+        r.add_testsuite(t_ts2);
+        ASSERT_EQ(r.run(c), 0);
+        ASSERT_EQ(out.str(), "testsuite1/test\ntestsuite2/test\ntestsuite2/gen\n");
+        ASSERT_EQ(t_ts1->statistics().tests(), 0UL);
+        out.str("");
+        c.report_fmt = config::report_format::JSON;
+        c.f_mode     = config::filter_mode::INCLUDE;
+        c.f_patterns.emplace_back("testsuite1");
+        ASSERT_EQ(r.run(c), 0);
+        ASSERT_EQ(out.str(), "[\n  {\"suite\":\"testsuite1\",\"test\":\"test\"}\n]\n");
+    };
+#if defined(TPP_INTERN_HAS_SYS_FEATURES) && defined(TPP_TEST_MODULE)
+    TEST("tests from modules") {
+        config c;
+        c.report_cfg.ostream = &t_null;
+        c.modules.emplace_back(TPP_TEST_MODULE);
+        runner r;
+        r.add_testsuite(t_ts1);
+        ASSERT_EQ(r.run(c), 1);
+        ASSERT_EQ(t_ts1->statistics().tests(), 1UL);
+        ASSERT_EQ(r.run(c), -2);
+        ASSERT_THROWS(r.load("none.so"), std::runtime_error);
+    };
+    TEST("reload modules") {
+        config c;
+        c.report_cfg.ostream = &t_null;
+        runner     r;
+        auto const runs{[] {
+            return tpp::global_fixture<int>("module_runs", [] { return std::unique_ptr<int>(new int(0)); });
+        }};
+        auto const before{runs()};
+        auto const ts1{r.reload(TPP_TEST_MODULE)};
+        ASSERT_EQ(r.run(c), 1);
+        auto const ts2{r.reload(TPP_TEST_MODULE)};
+        ASSERT_EQ(r.run(c), 1);
+        ASSERT_EQ(ts1.size(), 1UL);
+        ASSERT_EQ(ts2.size(), 1UL);
+        ASSERT_NOT_EQ(ts1.front(), ts2.front());
+        ASSERT_EQ(ts2.front()->statistics().tests(), 3UL);
+        ASSERT_EQ(runs(), before + 2);
+        ASSERT_THROWS(r.reload("none.so"), std::runtime_error);
+    };
+#endif
+#ifdef TPP_INTERN_HAS_SYS_FEATURES
+    TEST("resume from journal") {
+        std::atomic<int> runs{0};
+        auto const       make_runner{[&](runner& r_) {
+            auto ts{testsuite_parallel::create("journaled")};
+            ts->test("pass", [&] { ++runs; });
+            ts->test("fail", [&] {
+                ++runs;
+                ASSERT_TRUE(false);
+            });
+            ts->generate("gen", 2000, [&](std::size_t i_) {
+                ++runs;
+                ASSERT_NOT_EQ(i_, 1500UL);
+            });
+            r_.add_testsuite(ts);
+            return ts;
+        }};
+        config c;
+        c.report_cfg.ostream = &t_null;
+        c.journal            = "/tmp/tpp_test_journal_" + std::to_string(::getpid());
+        runner r1;
+        make_runner(r1);
+        ASSERT_EQ(r1.run(c), 2);
+        ASSERT_EQ(runs.load(), 2002);
+        std::ifstream in(c.journal, std::ios::binary | std::ios::ate);
+        auto const    size{static_cast<off_t>(in.tellg())};
+        ASSERT_EQ(::truncate(c.journal.c_str(), size - 1), 0);
+        runs     = 0;
+        c.resume = true;
+        runner     r2;
+        auto const ts{make_runner(r2)};
+        ASSERT_EQ(r2.run(c), 2);
+        ASSERT_GT(runs.load(), 0);
+        ASSERT_LT(runs.load(), 2002);
+        ASSERT_EQ(ts->statistics().tests(), 2002UL);
+        ASSERT_EQ(ts->statistics().failures(), 2UL);
+        ASSERT_EQ(std::string(ts->testcases().at(2).name()), "gen #1500");
+        std::ofstream(c.journal, std::ios::binary) << "garbage, that is not a journal";
+        runner r3;
+        make_runner(r3);
+        ASSERT_EQ(r3.run(c), 2);
+        c.dist = config::dist_mode::SERVE;
+        ASSERT_EQ(r3.run(c), -2);
+        std::remove(c.journal.c_str());
+    };
+    TEST("isolated by fork") {
+        int fixture{0};
+        t_ts1->setup([&] { fixture = 1; });
+        t_ts1->test("modify", [&] {
+            ASSERT_EQ(fixture, 1);
+            fixture = 2;
+        });
+        t_ts1->test("pristine", [&] {
+            ASSERT_EQ(fixture, 1);
+            std::cout << "out";
+        });
+        t_ts2->test("crash", [] { std::raise(SIGKILL); });
+        t_ts2->generate("gen", 100, [](std::size_t i_) { ASSERT_LT(i_, 99UL); });
+        config c;
+        c.report_cfg.ostream = &t_null;
+        c.isolate            = true;
+        runner r;
+        r.add_testsuite(t_ts1);
+        r.add_testsuite(t_ts2);
+        ASSERT_EQ(r.run(c), 2);
+        ASSERT_EQ(fixture, 1);
+        ASSERT_EQ(t_ts1->statistics().successes(), 3UL);
+        ASSERT_EQ(t_ts1->testcases().at(2).cout(), "out");
+        ASSERT_EQ(t_ts2->statistics().errors(), 1UL);
+        ASSERT_EQ(t_ts2->statistics().failures(), 1UL);
+        ASSERT_EQ(t_ts2->statistics().tests(), 102UL);
+        ASSERT_IN("signal 9", std::string(t_ts2->testcases().at(1).reason()));
+        c.run_cfg.retries = 1;
+        ASSERT_EQ(r.run(c), -2);
+    };
+    TEST("isolated child timed out") {
+        t_ts1->test("hang", [] { std::this_thread::sleep_for(std::chrono::hours(1)); });
+        fork_isolation(*t_ts1, run_config{}, 2, std::chrono::milliseconds(200)).run();
+        ASSERT_EQ(t_ts1->statistics().successes(), 1UL);
+        ASSERT_EQ(t_ts1->statistics().errors(), 1UL);
+        ASSERT_EQ(std::string(t_ts1->testcases().at(1).reason()), "child process timed out, and was killed");
+    };
+    TEST("retries and quarantine") {
+        int runs{0};
+        t_ts1->test("flaky", [&] { ASSERT_GT(++runs, 1); });
+        t_ts2->test("broken", [] { ASSERT_TRUE(false); });
+        config c;
+        c.report_cfg.ostream = &t_null;
+        c.run_cfg.retries    = 2;
+        c.quarantine         = "/tmp/tpp_test_quarantine_" + std::to_string(::getpid());
+        std::ofstream(c.quarantine) << "# known to fail\n\ntestsuite2/broken\n";
+        runner r;
+        r.add_testsuite(t_ts1);
+        r.add_testsuite(t_ts2);
+        ASSERT_EQ(r.run(c), 0);
+        ASSERT_EQ(runs, 2);
+        ASSERT_EQ(t_ts1->statistics().flaky(), 1UL);
+        ASSERT_EQ(t_ts2->statistics().failures(), 1UL);
+        ASSERT_EQ(t_ts2->testcases().at(1).attempts().size(), 2UL);
+        std::remove(c.quarantine.c_str());
+        ASSERT_EQ(r.run(c), -2);
+        c.quarantine.clear();
+        c.journal = "journal";
+        ASSERT_EQ(r.run(c), -2);
+    };
+    TEST("repeated runs with other configs") {
+        t_ts2->test("broken", [] { ASSERT_TRUE(false); });
+        auto const seed{tpp::intern::random::source::seed().load()};
+        config     c;
+        c.report_cfg.ostream = &t_null;
+        c.quarantine         = "/tmp/tpp_test_quarantine_repeated_" + std::to_string(::getpid());
+        c.seeded             = true;
+        c.seed               = 42;
+        std::ofstream(c.quarantine) << "testsuite2/broken\n";
+        runner r;
+        r.add_testsuite(t_ts1);
+        r.add_testsuite(t_ts2);
+        ASSERT_EQ(r.run(c), 0);
+        ASSERT_EQ(tpp::intern::random::source::seed().load(), 42UL);
+        config c2;
+        c2.report_cfg.ostream = &t_null;
+        ASSERT_EQ(r.run(c2), 1);
+        ASSERT_NOT_EQ(tpp::intern::random::source::seed().load(), 42UL);
+        std::remove(c.quarantine.c_str());
+        tpp::intern::random::source::seed() = seed;
+    };
+    TEST("tests affected by changed files") {
+        t_ts2->generate("gen", 2, [](std::size_t) {});
+        config c;
+        c.report_cfg.ostream = &t_null;
+        c.coverage_map       = "/tmp/tpp_test_impact_" + std::to_string(::getpid());
+        c.impact             = true;
+        c.changed_files.emplace_back("b.cpp");
+        std::ofstream(c.coverage_map) << "tpp-coverage-map 1\nF\t/b/a.cpp\nF\t/b/b.cpp\nT\ttestsuite1/test\t0 \n"
+                                         "T\ttestsuite2/test\t1 \nT\ttestsuite2/gen\t0 \n";
+        runner r;
+        r.add_testsuite(t_ts1);
+        r.add_testsuite(t_ts2);
+        ASSERT_EQ(r.run(c), 0);
+        ASSERT_EQ(t_ts1->statistics().tests(), 0UL);
+        ASSERT_EQ(t_ts2->statistics().tests(), 1UL);
+        c.changed_files.emplace_back("c.cpp");
+        t_ts1 = testsuite::create("testsuite1");
+        t_ts1->test("test", [] {});
+        t_ts1->test("new", [] {});
+        runner r2;
+        r2.add_testsuite(t_ts1);
+        ASSERT_EQ(r2.run(c), 0);
+        ASSERT_EQ(t_ts1->statistics().tests(), 2UL);
+        std::ofstream(c.coverage_map) << "not a map";
+        ASSERT_EQ(r2.run(c), -2);
+        std::remove(c.coverage_map.c_str());
+        c.coverage_map.clear();
+        ASSERT_EQ(r2.run(c), -2);
+    };
+#    ifdef TPP_COVERAGE
+    TEST("record coverage map") {
+        config c;
+        c.report_cfg.ostream = &t_null;
+        c.coverage_map       = "/tmp/tpp_test_coverage_" + std::to_string(::getpid());
+        // Run in a child process, which discards its coverage counters, so that they are kept for this process.
+        auto const child{::fork()};
+        if (child == 0) {
+            runner r;
+            r.add_testsuite(t_ts1);
+            r.add_testsuite(t_ts2);
+            ::_exit(r.run(c));
+        }
+        int status{-1};
+        ASSERT_EQ(::waitpid(child, &status, 0), child);
+        ASSERT_TRUE(WIFEXITED(status));
+        ASSERT_EQ(WEXITSTATUS(status), 0);
+        auto const            map{coverage_map::load(c.coverage_map)};
+        std::set<std::string> tests;
+        ASSERT_TRUE(map.affected(std::vector<std::string>{"test/reflexive_tests.cpp"}, tests));
+        ASSERT_EQ(tests.size(), 2UL);
+        ASSERT_TRUE(map.contains("testsuite2/test"));
+        ASSERT_FALSE(map.affected(std::vector<std::string>{"test/none.cpp"}, tests));
+        std::remove(c.coverage_map.c_str());
+    };
+#    endif
+#endif
 };
 
 #ifdef TPP_INTERN_SYS_UNIX
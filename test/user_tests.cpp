@@ -66,3 +66,10 @@ DESCRIBE_PAR("TestMyClass") {
         std::cerr << "print \"quoted\"" << std::endl;
     }
 };
+
+SUITE("TestGenerated") {
+    TEST_GENERATOR("squares are non-negative", 1000, i) {
+        auto const x = static_cast<long>(i) - 500L;
+        ASSERT_NOT_LT(x * x, 0L);
+    }
+};